@@ -1,84 +1,316 @@
 #include "Guild.hpp"
+#include <new>
+
+namespace {
+
+/**
+ * @brief A roster_index_ key for looking up a name, built in a stack buffer so that
+ * lookups allocate nothing from any resource for all but very long names.
+ */
+class LookupKey {
+    public:
+        explicit LookupKey(const std::string& name) : key_(name, &arena_) {}
+
+        const std::pmr::string& get() const { return key_; }
+    private:
+        char buffer_[256];
+        std::pmr::monotonic_buffer_resource arena_{buffer_, sizeof(buffer_)};
+        std::pmr::string key_;
+};
+
+} // namespace
+
+/**
+ * @brief Constructs a new Guild object. Initializes the enlisted_players vector
+ * and its name index.
+ * @param pool The pool to store enlisted players in.
+ */
+Guild::Guild(std::shared_ptr<PlayerPool> pool)
+    : pool_{std::move(pool)}, enlisted_players{pool_->resource()}, roster_index_{pool_->resource()} {}
 
 /**
- * @brief Constructs a new Guild object. Initializes the enlisted_players vector.
+ * @brief Constructs a new Guild object with a private PlayerPool in the given memory resource.
+ * @param resource The memory resource for the guild's pool, roster and members' Inventories.
  */
-Guild::Guild() : enlisted_players{std::vector<Player>()} {}
+Guild::Guild(std::pmr::memory_resource* resource)
+    : Guild(std::allocate_shared<PlayerPool>(std::pmr::polymorphic_allocator<PlayerPool>{resource}, resource)) {}
+
+/**
+* @brief Closes the gap left at `slot` by moving the last handle into it (swap-and-pop).
+*
+* @param slot The index of an already-vacated handle in enlisted_players
+* @post enlisted_players shrinks by one and the moved handle's roster_index_ entry is updated.
+*/
+void Guild::fillVacancy(size_t slot) {
+    if (slot != enlisted_players.size() - 1) {
+        enlisted_players[slot] = enlisted_players.back();
+        roster_index_.find(LookupKey(pool_->get(enlisted_players[slot]).getName()).get())->second = slot;
+    }
+    enlisted_players.pop_back();
+}
+
+/**
+* @brief Empties the roster, reconstructing its containers if they use another resource.
+* @post enlisted_players and roster_index_ are empty and allocate from pool_->resource().
+*/
+void Guild::resetRoster() {
+    std::pmr::memory_resource* resource = pool_->resource();
+    if (enlisted_players.get_allocator().resource() == resource) {
+        enlisted_players.clear();
+        roster_index_.clear();
+        return;
+    }
+    // Neither container allocates when constructed empty, so this cannot throw part-way
+    enlisted_players.~vector();
+    new (&enlisted_players) std::pmr::vector<PlayerHandle>(resource);
+    roster_index_.~unordered_map();
+    new (&roster_index_) std::pmr::unordered_map<std::pmr::string, size_t>(resource);
+}
 
 /**
-* @brief Searches for a player in the guild by name
-* 
+* @brief Searches for a player in the guild by name in O(1) expected time
+*
 * @param playerName A const reference to the player's name to search for
-* @return std::vector<Player>::iterator An iterator pointing to the found player, or enlisted_players.end() if not found
+* @return Player* A pointer to the found player, or nullptr if not found
+*/
+Player* Guild::findPlayer(const std::string& playerName) {
+    auto slot = roster_index_.find(LookupKey(playerName).get());
+    if (slot == roster_index_.end()) { return nullptr; }
+    return &pool_->get(enlisted_players[slot->second]);
+}
+
+/**
+* @brief Retrieves the number of players enlisted in the guild
+* @return The size of enlisted_players
 */
-std::vector<Player>::iterator Guild::findPlayer(const std::string& playerName) {
-    return std::find_if(enlisted_players.begin(), enlisted_players.end(), [&playerName](const Player& p) {
-        return p.getName() == playerName;
-    });
+size_t Guild::size() const {
+    return enlisted_players.size();
 }
 
 /**
 * @brief Attempts to enlist a player into the guild
-* 
+*
 * @param player An l-value reference to a Player object whose contents will be moved into the guild
 * @return True if the player was successfully enlisted, false if a player with the same name already exists
-* 
-* @post If successful, player's contents are moved into the guild's enlisted_players 
-*       vector and the original player object is left in a valid but unspecified state.
+*
+* @post If successful, player's contents are moved into the guild's pool
+*       and the original player object is left in a valid but unspecified state.
 *       If unsuccessful, player remains unchanged.
 */
 bool Guild::enlistPlayer(Player& player) {
-    if (findPlayer(player.getName()) != enlisted_players.end()) { return false; }
-    enlisted_players.push_back(std::move(player));
+    if (!roster_index_.emplace(player.getName(), enlisted_players.size()).second) { return false; }
+    enlisted_players.push_back(pool_->acquire(std::move(player)));
     return true;
 }
 
 /**
 * @brief Moves a player from this guild to another guild
-* 
+*
 * @param playerName A const reference to the name of the player to move
 * @param target An l-value reference to the destination Guild
-* @return True if the player was successfully moved, 
+* @return True if the player was successfully moved,
 *       false if the player doesn't exist in this guild
 *       or if a player with the same name already exists in the target guild
-* 
-* @post If successful, the specified player is moved from 
-*       this guild to the target guild, and their content is erased from the source guild
+*
+* @post If successful, the specified player is moved from
+*       this guild to the target guild, and their handle is erased from the source guild
 *       If unsuccessful, both guilds remain unchanged.
 */
 bool Guild::movePlayerTo(const std::string& playerName, Guild& target) {
-    auto existingPlayerItr = target.findPlayer(playerName);
-    if (existingPlayerItr != target.enlisted_players.end()) { return false; }
+    LookupKey key(playerName);
+    if (target.roster_index_.count(key.get())) { return false; }
+
+    auto movingSlot = roster_index_.find(key.get());
+    if (movingSlot == roster_index_.end()) { return false; }
+    size_t slot = movingSlot->second;
+    PlayerHandle handle = enlisted_players[slot];
 
-    auto movingPlayerItr = findPlayer(playerName);
-    if (movingPlayerItr == enlisted_players.end()) { return false; }
+    // Index the player in the target before moving, since playerName may alias the player's name
+    target.roster_index_.emplace(playerName, target.enlisted_players.size());
+    if (target.pool_ == pool_) {
+        target.enlisted_players.push_back(handle);
+    } else {
+        target.enlisted_players.push_back(target.pool_->acquire(std::move(pool_->get(handle))));
+        pool_->release(handle);
+    }
 
-    target.enlisted_players.push_back(std::move(*movingPlayerItr));
-    enlisted_players.erase(movingPlayerItr);
+    roster_index_.erase(movingSlot);
+    fillVacancy(slot);
 
     return true;
 }
 
 /**
 * @brief Copies a player from this guild to another guild
-* 
+*
 * @param playerName A const reference to the name of the player to copy
 * @param target An l-value reference to the destination Guild
-* @return True if the player was successfully copied, 
+* @return True if the player was successfully copied,
 *         false if the player doesn't exist in this guild
 *         or if a player with the same name already exists in the target guild
-* 
+*
 * @post If successful, a copy of the specified player is added to the target guild.
 *       If unsuccessful, both guilds remain unchanged.
 *       In either case, the original player in this guild remains unchanged.
 */
 bool Guild::copyPlayerTo(const std::string& playerName, Guild& target) {
-    auto existingPlayerItr = target.findPlayer(playerName);
-    if (existingPlayerItr != target.enlisted_players.end()) { return false; }
+    if (target.roster_index_.count(LookupKey(playerName).get())) { return false; }
 
-    auto copiedPlayerItr = findPlayer(playerName);
-    if (copiedPlayerItr == enlisted_players.end()) { return false; }
+    Player* copiedPlayer = findPlayer(playerName);
+    if (!copiedPlayer) { return false; }
 
-    target.enlisted_players.push_back(*copiedPlayerItr);
+    target.roster_index_.emplace(playerName, target.enlisted_players.size());
+    target.enlisted_players.push_back(target.pool_->acquire(*copiedPlayer));
     return true;
-}
\ No newline at end of file
+}
+
+/**
+* @brief Attempts to enlist a batch of players into the guild
+*
+* @param players An r-value reference to the players to move into the guild
+* @return std::vector<bool> Whether each player was enlisted
+*/
+std::vector<bool> Guild::enlistAll(std::vector<Player>&& players) {
+    std::vector<bool> enlisted(players.size(), false);
+    enlisted_players.reserve(enlisted_players.size() + players.size());
+    roster_index_.reserve(roster_index_.size() + players.size());
+
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (!roster_index_.emplace(players[i].getName(), enlisted_players.size()).second) { continue; }
+        enlisted_players.push_back(pool_->acquire(std::move(players[i])));
+        enlisted[i] = true;
+    }
+    return enlisted;
+}
+
+/**
+* @brief Moves a batch of players from this guild to another guild
+*
+* @param playerNames A const reference to the names of the players to move
+* @param target An l-value reference to the destination Guild
+* @return std::vector<bool> Whether each player was moved
+*/
+std::vector<bool> Guild::moveAllTo(const std::vector<std::string>& playerNames, Guild& target) {
+    std::vector<bool> moved(playerNames.size(), false);
+    target.enlisted_players.reserve(target.enlisted_players.size() + playerNames.size());
+    target.roster_index_.reserve(target.roster_index_.size() + playerNames.size());
+
+    for (size_t i = 0; i < playerNames.size(); ++i) {
+        moved[i] = movePlayerTo(playerNames[i], target);
+    }
+    return moved;
+}
+
+/**
+* @brief Moves every player of this guild into another guild in a single pass
+*
+* @param target An l-value reference to the destination Guild
+* @return std::vector<std::string> The names of the players that stayed behind
+*/
+std::vector<std::string> Guild::mergeInto(Guild& target) {
+    std::vector<std::string> conflicts;
+    if (&target == this) { return conflicts; }
+
+    target.enlisted_players.reserve(target.enlisted_players.size() + enlisted_players.size());
+    target.roster_index_.reserve(target.roster_index_.size() + enlisted_players.size());
+
+    // Compact the players that stay behind to the front as we go
+    size_t kept = 0;
+    for (const PlayerHandle& handle : enlisted_players) {
+        Player& player = pool_->get(handle);
+        if (!target.roster_index_.emplace(player.getName(), target.enlisted_players.size()).second) {
+            conflicts.push_back(player.getName());
+            enlisted_players[kept++] = handle;
+            continue;
+        }
+        if (target.pool_ == pool_) {
+            target.enlisted_players.push_back(handle);
+        } else {
+            target.enlisted_players.push_back(target.pool_->acquire(std::move(player)));
+            pool_->release(handle);
+        }
+    }
+    enlisted_players.resize(kept);
+
+    roster_index_.clear();
+    for (size_t slot = 0; slot < kept; ++slot) {
+        roster_index_.emplace(conflicts[slot], slot);
+    }
+    return conflicts;
+}
+
+/**
+* @brief Copy constructor. Copies each of rhs's players into rhs's pool.
+* @param rhs The Guild to copy from.
+*/
+Guild::Guild(const Guild& rhs)
+    : pool_{rhs.pool_}, enlisted_players{pool_->resource()}, roster_index_{rhs.roster_index_, pool_->resource()} {
+    enlisted_players.reserve(rhs.enlisted_players.size());
+    for (const PlayerHandle& handle : rhs.enlisted_players) {
+        enlisted_players.push_back(pool_->acquire(pool_->get(handle)));
+    }
+}
+
+/**
+* @brief Move constructor. Takes over rhs's handles.
+* @param rhs The Guild to move from.
+* @post rhs is left with no players, still attached to its pool.
+*/
+Guild::Guild(Guild&& rhs)
+    : pool_{rhs.pool_}, enlisted_players{std::move(rhs.enlisted_players)}, roster_index_{std::move(rhs.roster_index_)} {
+    rhs.enlisted_players.clear();
+    rhs.roster_index_.clear();
+}
+
+/**
+* @brief Copy assignment operator.
+* @param rhs The Guild to copy from.
+* @return Guild& A reference to the assigned Guild.
+* @post This guild's players are released and replaced by copies of rhs's players.
+*/
+Guild& Guild::operator=(const Guild& rhs) {
+    if (this != &rhs) {
+        for (const PlayerHandle& handle : enlisted_players) {
+            pool_->release(handle);
+        }
+        pool_ = rhs.pool_;
+        resetRoster();
+        enlisted_players.reserve(rhs.enlisted_players.size());
+        for (const PlayerHandle& handle : rhs.enlisted_players) {
+            enlisted_players.push_back(pool_->acquire(pool_->get(handle)));
+        }
+        roster_index_ = rhs.roster_index_;
+    }
+    return *this;
+}
+
+/**
+* @brief Move assignment operator.
+* @param rhs The Guild to move from.
+* @return Guild& A reference to the assigned Guild.
+* @post This guild's players are released and rhs's handles are taken over.
+*/
+Guild& Guild::operator=(Guild&& rhs) {
+    if (this != &rhs) {
+        for (const PlayerHandle& handle : enlisted_players) {
+            pool_->release(handle);
+        }
+        pool_ = rhs.pool_;
+        resetRoster(); // Now on rhs's resource, so the moves below take over its buffers
+        enlisted_players = std::move(rhs.enlisted_players);
+        roster_index_ = std::move(rhs.roster_index_);
+
+        rhs.enlisted_players.clear();
+        rhs.roster_index_.clear();
+    }
+    return *this;
+}
+
+/**
+* @brief Destructor. Releases every enlisted player from the pool.
+*/
+Guild::~Guild() {
+    for (const PlayerHandle& handle : enlisted_players) {
+        pool_->release(handle);
+    }
+}
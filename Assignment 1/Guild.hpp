@@ -1,29 +1,91 @@
 #pragma once
 
 #include "Player.hpp"
+#include "PlayerPool.hpp"
+#include <memory>
+#include <memory_resource>
+#include <string>
 #include <vector>
+#include <unordered_map>
 #include <algorithm>
 #include <iterator>
 
 class Guild {
     private: 
         /**
-        * @brief A vector containing the players currently enlisted in the guild.
+        * @brief The pool that owns the enlisted Player objects.
+        * Guilds sharing a pool move players between each other by handle only.
         */
-        std::vector<Player> enlisted_players;
+        std::shared_ptr<PlayerPool> pool_;
+
+        /**
+        * @brief A vector containing handles to the players currently enlisted in the guild.
+        * Like roster_index_, it allocates from the pool's memory resource.
+        */
+        std::pmr::vector<PlayerHandle> enlisted_players;
+
+        /**
+        * @brief Maps each enlisted player's name to their index in enlisted_players.
+        * The keys are pmr strings, so long names are copied into the pool's memory resource too.
+        */
+        std::pmr::unordered_map<std::pmr::string, size_t> roster_index_;
+
+        /**
+        * @brief Closes the gap left at `slot` by moving the last player into it (swap-and-pop).
+        * 
+        * @param slot The index in enlisted_players of a handle that has already been
+        *       transferred or released and whose roster_index_ entry has already been erased
+        * @post enlisted_players shrinks by one and the moved handle's roster_index_ entry is updated.
+        *       The relative order of the remaining players is not preserved.
+        */
+        void fillVacancy(size_t slot);
+
+        /**
+        * @brief Empties the roster, rebuilding its containers on the pool's memory resource
+        *       if they allocate from a different one.
+        *
+        * pmr containers never adopt another resource on assignment, so after `pool_` changes
+        * they are destroyed & reconstructed in place instead.
+        * @post enlisted_players and roster_index_ are empty and allocate from pool_->resource().
+        */
+        void resetRoster();
     public:
         /**
-         * @brief Constructs a new Guild object. Initializes the enlisted_players vector.
+         * @brief Constructs a new Guild object. Initializes the enlisted_players vector
+         * and its name index.
+         * @param pool The pool to store enlisted players in.
+         *      Defaults to the process-wide PlayerPool::shared() pool.
          */
-        Guild();
+        Guild(std::shared_ptr<PlayerPool> pool = PlayerPool::shared());
 
         /**
-        * @brief Searches for a player in the guild by name
+         * @brief Constructs a new Guild object with a private PlayerPool in the given memory resource.
+         * @param resource The memory resource for the guild's pool, roster and members' Inventories.
+         * 
+         * @note With a std::pmr::monotonic_buffer_resource, enlisting players does no
+         *      individual heap allocations once the arena is warm, and releasing the
+         *      arena after the guild is destroyed frees every member at once.
+         *      The one exception is a member's name itself: Player::getName() is a
+         *      std::string, so a name too long for its small-string buffer (15 chars
+         *      with libstdc++) is still allocated from the default resource.
+         *      The resource must outlive the guild and every guild sharing its pool.
+         */
+        explicit Guild(std::pmr::memory_resource* resource);
+
+        /**
+        * @brief Searches for a player in the guild by name in O(1) expected time
         * 
         * @param playerName A const reference to the player's name to search for
-        * @return std::vector<Player>::iterator An iterator pointing to the found player, or enlisted_players.end() if not found
+        * @return Player* A pointer to the found player, or nullptr if not found.
+        *       The pointer stays valid until the player leaves the guild's pool.
         */
-        std::vector<Player>::iterator findPlayer(const std::string& playerName);
+        Player* findPlayer(const std::string& playerName);
+
+        /**
+        * @brief Retrieves the number of players enlisted in the guild
+        * @return The size of enlisted_players
+        */
+        size_t size() const;
 
         /**
         * @brief Attempts to enlist a player into the guild
@@ -31,8 +93,8 @@ class Guild {
         * @param player An l-value reference to a Player object whose contents will be moved into the guild
         * @return True if the player was successfully enlisted, false if a player with the same name already exists
         * 
-        * @post If successful, player's contents are moved into the guild's enlisted_players 
-        *       vector and the original player object is left in a valid but unspecified state.
+        * @post If successful, player's contents are moved into the guild's pool 
+        *       and the original player object is left in a valid but unspecified state.
         *       If unsuccessful, player remains unchanged.
         */
         bool enlistPlayer(Player& player);
@@ -47,7 +109,9 @@ class Guild {
         *       or if a player with the same name already exists in the target guild
         * 
         * @post If successful, the specified player is moved from 
-        *       this guild to the target guild, and their content is erased from the source guild
+        *       this guild to the target guild, and their handle is erased from the source guild
+        *       by moving the source guild's last handle into the vacated slot.
+        *       If both guilds share a pool, only the handle moves; the Player object stays put.
         *       If unsuccessful, both guilds remain unchanged.
         */
         bool movePlayerTo(const std::string& playerName, Guild& target);
@@ -66,4 +130,83 @@ class Guild {
         *       In either case, the original player in this guild remains unchanged.
         */
         bool copyPlayerTo(const std::string& playerName, Guild& target);
+
+        /**
+        * @brief Attempts to enlist a batch of players into the guild
+        * 
+        * @param players An r-value reference to the players whose contents will be moved into the guild
+        * @return A vector of the same length as `players`, where entry i is true if players[i]
+        *       was enlisted, false if a player with the same name was already in the guild
+        *       (including an earlier player in the same batch)
+        * 
+        * @post Roster storage is reserved once for the whole batch.
+        *       Successfully enlisted players are left in a valid but unspecified state.
+        */
+        std::vector<bool> enlistAll(std::vector<Player>&& players);
+
+        /**
+        * @brief Moves a batch of players from this guild to another guild
+        * 
+        * @param playerNames A const reference to the names of the players to move
+        * @param target An l-value reference to the destination Guild
+        * @return A vector of the same length as `playerNames`, where entry i is the result
+        *       movePlayerTo(playerNames[i], target) would have returned
+        * 
+        * @post The target's roster storage is reserved once for the whole batch,
+        *       and each player is moved in O(1) expected time.
+        */
+        std::vector<bool> moveAllTo(const std::vector<std::string>& playerNames, Guild& target);
+
+        /**
+        * @brief Moves every player of this guild into another guild in a single pass
+        * 
+        * @param target An l-value reference to the destination Guild
+        * @return The names of the players that stayed behind because
+        *       a player with the same name already exists in the target guild
+        * 
+        * @post All other players are moved to the target guild. If both guilds share a pool,
+        *       only handles move. This guild keeps just the players named in the result.
+        */
+        std::vector<std::string> mergeInto(Guild& target);
+
+        // Big Five
+
+        /**
+        * @brief Copy constructor for the Guild class.
+        * @param rhs A const l-value ref. to the Guild to copy.
+        * @post Shares `rhs`'s pool and copies each of its players into it under new handles.
+        *       The roster allocates from the pool's memory resource.
+        */
+        Guild(const Guild& rhs);
+
+        /**
+        * @brief Move constructor for the Guild class.
+        * @param rhs An r-value ref. to the Guild to move from.
+        * @post Takes over `rhs`'s pool and handles. `rhs` is left with no players.
+        */
+        Guild(Guild&& rhs);
+
+        /**
+        * @brief Copy assignment operator for the Guild class.
+        * @param rhs A const l-value ref. to the Guild to copy.
+        * @return A reference to the updated Guild.
+        * @post Releases this guild's players, then copies each of `rhs`'s players into `rhs`'s pool.
+        *       The roster is rebuilt on that pool's memory resource.
+        */
+        Guild& operator=(const Guild& rhs);
+
+        /**
+        * @brief Move assignment operator for the Guild class.
+        * @param rhs An r-value ref. to the Guild to move from.
+        * @return A reference to the updated Guild.
+        * @post Releases this guild's players and takes over `rhs`'s pool and handles.
+        *       The roster is rebuilt on that pool's memory resource. `rhs` is left with no players.
+        */
+        Guild& operator=(Guild&& rhs);
+
+        /**
+        * @brief Destructor for the Guild class.
+        * @post Releases every enlisted player from the pool.
+        */
+        ~Guild();
 };
\ No newline at end of file
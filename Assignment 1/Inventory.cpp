@@ -6,36 +6,208 @@
 //  Description: This program implements Inventory class
 
 #include "Inventory.hpp"
+#include <algorithm> // for std::max, std::min
 #include <stdexcept> // for std::out_of_range
 
 /**
     *@brief Default constructor with optional parameters
     *@param items: 2D vector of items to initialize the inventory grid
     *@param equipped: pointer to the item to initialize the equipped item
+    *@param resource: memory resource to allocate the grid and equipped item from
     *@return inventory object
 */
 Inventory::Inventory(
     const std::vector<std::vector<Item>>& items,
-    Item* equipped)
-    : inventory_grid_{items}, equipped_{equipped ? new Item(*equipped) : nullptr}, weight_{0.0f}, item_count_{0} {
+    Item* equipped,
+    std::pmr::memory_resource* resource)
+    : grid_{nullptr}, equipped_{nullptr}, resource_{resource} {
+    if (equipped) {
+        equipped_ = allocateItem(*equipped);
+    }
+    auto grid = allocateGrid(nullptr);
+    grid->rows_ = items.size();
+
+    // The grid is as wide as the longest row; shorter rows are padded with NONE items
+    for (const auto& row : items) {
+        grid->cols_ = std::max(grid->cols_, row.size());
+    }
+    grid->inventory_grid_.resize(grid->rows_ * grid->cols_);
+    grid->occupied_.assign((grid->rows_ * grid->cols_ + 63) / 64, 0);
 
-    // Calculate the initial weight and item_count excluding NONE types
-    for (const auto& row : inventory_grid_) {
-        for (const auto& item : row) {
+    // Flatten the rows and calculate the initial weight excluding NONE types
+    for (size_t r = 0; r < grid->rows_; ++r) {
+        for (size_t c = 0; c < items[r].size(); ++c) {
+            const Item& item = items[r][c];
+            grid->inventory_grid_[r * grid->cols_ + c] = item;
             if (item.type_ != NONE) {
-                weight_ += item.weight_;
-                ++item_count_;
+                grid->weight_ += item.weight_;
+                grid->markOccupied(r * grid->cols_ + c);
             }
         }
     }
+
+    // Count the occupied cells straight from the bitmap
+    for (const uint64_t& word : grid->occupied_) {
+        grid->item_count_ += __builtin_popcountll(word);
+    }
+    grid->first_free_ = grid->nextFree(0);
+    grid_ = std::move(grid);
+}
+
+/**
+    *@brief Constructs an empty grid
+    *@param resource: memory resource for the grid's containers
+*/
+Inventory::Grid::Grid(std::pmr::memory_resource* resource)
+    : inventory_grid_{resource}, occupied_{resource} {}
+
+/**
+    *@brief Copies a grid into another memory resource
+    *@param rhs: the grid to copy
+    *@param resource: memory resource for the copy's containers
+*/
+Inventory::Grid::Grid(const Grid& rhs, std::pmr::memory_resource* resource)
+    : inventory_grid_{rhs.inventory_grid_, resource}, rows_{rhs.rows_}, cols_{rhs.cols_},
+      occupied_{rhs.occupied_, resource}, weight_{rhs.weight_}, item_count_{rhs.item_count_},
+      first_free_{rhs.first_free_} {}
+
+/**
+    *@brief Converts a row and column into a flat index of the grid
+    *@param row The row index.
+    *@param col The column index.
+    *@return size_t The row-major index of the cell
+    *@throws std::out_of_range if the row or column is out of range.
+*/
+size_t Inventory::Grid::indexOf(const size_t& row, const size_t& col) const {
+    if (row >= rows_ || col >= cols_) {
+        throw std::out_of_range("Row or column out of range"); // Throw exception if out of range
+    }
+    return row * cols_ + col;
 }
 
 /**
-    *@brief Get the equipped item
-    *@return pointer to the equipped item
+    *@brief Checks a cell against the occupancy bitmap
+    *@param index The row-major index of the cell
+    *@return bool True if the cell is occupied
 */
-Item* Inventory::getEquipped() const {
-    return equipped_; // Return the equipped item
+bool Inventory::Grid::isOccupied(const size_t& index) const {
+    return (occupied_[index / 64] >> (index % 64)) & 1;
+}
+
+/**
+    *@brief Marks a cell as occupied in the occupancy bitmap
+    *@param index The row-major index of the cell
+*/
+void Inventory::Grid::markOccupied(const size_t& index) {
+    occupied_[index / 64] |= uint64_t{1} << (index % 64);
+}
+
+/**
+    *@brief Checks a run of cells against the occupancy bitmap, one word at a time
+    *@param index The row-major index of the first cell
+    *@param length The number of cells in the run
+    *@return bool True if none of the cells are occupied
+*/
+bool Inventory::Grid::isRangeFree(const size_t& index, const size_t& length) const {
+    size_t pos = index;
+    size_t end = index + length;
+    while (pos < end) {
+        size_t bit = pos % 64;
+        size_t span = std::min<size_t>(64 - bit, end - pos);
+        uint64_t mask = (span == 64 ? ~uint64_t{0} : ((uint64_t{1} << span) - 1)) << bit;
+        if (occupied_[pos / 64] & mask) {
+            return false;
+        }
+        pos += span;
+    }
+    return true;
+}
+
+/**
+    *@brief Marks a run of cells as occupied, one word at a time
+    *@param index The row-major index of the first cell
+    *@param length The number of cells in the run
+*/
+void Inventory::Grid::markRange(const size_t& index, const size_t& length) {
+    size_t pos = index;
+    size_t end = index + length;
+    while (pos < end) {
+        size_t bit = pos % 64;
+        size_t span = std::min<size_t>(64 - bit, end - pos);
+        uint64_t mask = (span == 64 ? ~uint64_t{0} : ((uint64_t{1} << span) - 1)) << bit;
+        occupied_[pos / 64] |= mask;
+        pos += span;
+    }
+}
+
+/**
+    *@brief Finds the lowest free cell at or after a given index
+    *@param from The row-major index to start searching from
+    *@return size_t The index of the free cell, or rows_ * cols_ if there is none
+*/
+size_t Inventory::Grid::nextFree(const size_t& from) const {
+    size_t cells = rows_ * cols_;
+    for (size_t word = from / 64; word < occupied_.size(); ++word) {
+        uint64_t free = ~occupied_[word];
+        if (word == from / 64) {
+            free &= ~uint64_t{0} << (from % 64); // Ignore cells before `from`
+        }
+        if (free) {
+            return std::min(cells, word * 64 + __builtin_ctzll(free));
+        }
+    }
+    return cells;
+}
+
+/**
+    *@brief Gets a grid that is safe to modify
+    *@return Grid& This inventory's grid, copied first if it is shared
+    *@post grid_ is not shared with any other Inventory
+*/
+Inventory::Grid& Inventory::mutableGrid() {
+    if (grid_.use_count() > 1) {
+        grid_ = allocateGrid(grid_.get()); // Copy-on-write
+    }
+    return const_cast<Grid&>(*grid_);
+}
+
+/**
+    *@brief Gets the shared empty grid
+    *@return const std::shared_ptr<const Grid>& A 0x0 grid shared by every moved-from Inventory
+*/
+const std::shared_ptr<const Inventory::Grid>& Inventory::emptyGrid() {
+    static const std::shared_ptr<const Grid> empty = std::make_shared<Grid>(std::pmr::new_delete_resource());
+    return empty;
+}
+
+/**
+    *@brief Allocates a grid, and its control block, from this inventory's memory resource
+    *@param source: the grid to copy, or nullptr for an empty grid
+    *@return std::shared_ptr<Grid> The new grid
+*/
+std::shared_ptr<Inventory::Grid> Inventory::allocateGrid(const Grid* source) const {
+    std::pmr::polymorphic_allocator<Grid> allocator{resource_};
+    if (source) {
+        return std::allocate_shared<Grid>(allocator, *source, resource_);
+    }
+    return std::allocate_shared<Grid>(allocator, resource_);
+}
+
+/**
+    *@brief Allocates a copy of an item from this inventory's memory resource
+    *@param item: the item to copy
+    *@return std::shared_ptr<const Item> The new item
+*/
+std::shared_ptr<const Item> Inventory::allocateItem(const Item& item) const {
+    return std::allocate_shared<Item>(std::pmr::polymorphic_allocator<Item>{resource_}, item);
+}
+
+/**
+    *@brief Get the equipped item for reading
+    *@return const pointer to the equipped item
+*/
+const Item* Inventory::getEquipped() const {
+    return equipped_.get(); // Return the equipped item
 }
 
 /**
@@ -44,10 +216,7 @@ Item* Inventory::getEquipped() const {
     *@post eqipped item is set to the item to equip
 */
 void Inventory::equip(Item* itemToEquip) {
-    if (equipped_) {
-        delete equipped_; // Delete the currently equipped item if it exists
-    }
-    equipped_ = itemToEquip ? new Item(*itemToEquip) : nullptr; // Equip the new item
+    equipped_ = itemToEquip ? allocateItem(*itemToEquip) : nullptr; // Equip the new item
 }
 
 /**
@@ -55,10 +224,7 @@ void Inventory::equip(Item* itemToEquip) {
     *@post the equipped item is set to nullptr
 */
 void Inventory::discardEquipped() {
-    if (equipped_) {
-        delete equipped_; // Delete the currently equipped item
-        equipped_ = nullptr; // Set equipped item to nullptr
-    }
+    equipped_.reset(); // Drop this inventory's share of the equipped item
 }
 
 /**
@@ -66,15 +232,77 @@ void Inventory::discardEquipped() {
     * @return std::vector<std::vector<Item>> A 2D vector of items in the inventory grid.
 */
 std::vector<std::vector<Item>> Inventory::getItems() const {
-    return inventory_grid_; // Return the inventory grid
+    const Grid& grid = *grid_;
+    std::vector<std::vector<Item>> items;
+    items.reserve(grid.rows_);
+    for (size_t r = 0; r < grid.rows_; ++r) {
+        items.emplace_back(grid.inventory_grid_.begin() + r * grid.cols_, grid.inventory_grid_.begin() + (r + 1) * grid.cols_);
+    }
+    return items; // Return the inventory grid, one vector per row
+}
+
+/**
+    * @brief Gets the underlying row-major grid without copying it.
+    * @return const std::pmr::vector<Item>& The flat grid of rows() * cols() items.
+*/
+const std::pmr::vector<Item>& Inventory::getGrid() const {
+    return grid_->inventory_grid_;
 }
 
 /**
-    * @brief Gets the total weight of items in the inventory. 
+    * @brief Gets a pointer to the first item of a row.
+    * @param row The row index.
+    * @return const Item* Pointer to cols() contiguous items.
+    * @throws std::out_of_range if the row is out of range.
+*/
+const Item* Inventory::rowData(const size_t& row) const {
+    if (row >= grid_->rows_) {
+        throw std::out_of_range("Row out of range"); // Throw exception if out of range
+    }
+    return grid_->inventory_grid_.data() + row * grid_->cols_;
+}
+
+/**
+    * @brief Gets the number of rows in the grid.
+    * @return size_t The number of rows.
+*/
+size_t Inventory::rows() const {
+    return grid_->rows_;
+}
+
+/**
+    * @brief Gets the number of columns in the grid.
+    * @return size_t The number of columns.
+*/
+size_t Inventory::cols() const {
+    return grid_->cols_;
+}
+
+/**
+    * @brief Gets the memory resource this inventory allocates from.
+    * @return std::pmr::memory_resource* The inventory's memory resource.
+*/
+std::pmr::memory_resource* Inventory::getResource() const {
+    return resource_;
+}
+
+/**
+    * @brief Checks whether a cell holds an item.
+    * @param row The row index.
+    * @param col The column index.
+    * @return bool True if the cell holds a non-NONE item.
+    * @throws std::out_of_range if the row or column is out of range.
+*/
+bool Inventory::isOccupied(const size_t& row, const size_t& col) const {
+    return grid_->isOccupied(grid_->indexOf(row, col));
+}
+
+/**
+    * @brief Gets the total weight of items in the inventory.
     * @return float The total weight of items.
 */
 float Inventory::getWeight() const {
-    return weight_; // Return the total weight of items
+    return grid_->weight_; // Return the total weight of items
 }
 
 /**
@@ -82,21 +310,18 @@ float Inventory::getWeight() const {
     * @return size_t The count of non-NONE items.
 */
 size_t Inventory::getCount() const {
-    return item_count_; // Return the count of non-NONE items
+    return grid_->item_count_; // Return the count of non-NONE items
 }
 
 /**
-    * @brief Retrieves an item at a specified row and column. 
+    * @brief Retrieves an item at a specified row and column.
     * @param row The row index.
     * @param col The column index.
-    * @return Item The item at the specified position.
+    * @return const Item& The item at the specified position.
     * @throws std::out_of_range if the row or column is out of range.
 */
-Item Inventory::at(const size_t& row, const size_t& col) const {
-    if (row >= inventory_grid_.size() || col >= inventory_grid_[row].size()) {
-        throw std::out_of_range("Row or column out of range"); // Throw exception if out of range
-    }
-    return inventory_grid_[row][col]; // Return the item at the specified position
+const Item& Inventory::at(const size_t& row, const size_t& col) const {
+    return grid_->inventory_grid_[grid_->indexOf(row, col)]; // Return the item at the specified position
 }
 
 /**
@@ -109,57 +334,170 @@ Item Inventory::at(const size_t& row, const size_t& col) const {
     * @post The item is stored in the specified cell if the cell is empty.
 */
 bool Inventory::store(const size_t& row, const size_t& col, const Item& pickup) {
-    if (row >= inventory_grid_.size() || col >= inventory_grid_[row].size()) {
-        throw std::out_of_range("Row or column out of range"); // Throw exception if out of range
-    }
+    size_t index = grid_->indexOf(row, col);
 
-    if (inventory_grid_[row][col].type_ != NONE) {
+    if (grid_->isOccupied(index)) {
         return false; // Return false if the cell is already occupied
     }
 
-    inventory_grid_[row][col] = pickup; // Store the item in the specified cell
-    weight_ += pickup.weight_; // Add the item's weight to the total weight
-    ++item_count_; // Increment the item count
+    if (pickup.type_ == NONE) {
+        return true; // Storing a NONE item leaves the cell empty
+    }
+
+    Grid& grid = mutableGrid();
+    grid.inventory_grid_[index] = pickup; // Store the item in the specified cell
+    grid.markOccupied(index);
+    grid.weight_ += pickup.weight_; // Add the item's weight to the total weight
+    ++grid.item_count_; // Increment the item count
     return true; // Return true indicating successful storage
 }
 
 /**
-    * @brief Copy constructor (deep copy).
+    * @brief Stores an item in the first free block of the inventory grid.
+    * @param pickup The item to store.
+    * @param height The number of rows the item covers.
+    * @param width The number of columns the item covers.
+    * @return The (row, col) of the top-left cell used, or std::nullopt if nothing fits.
+    * @post The item is stored at the top-left cell and its whole footprint is marked occupied.
+*/
+std::optional<std::pair<size_t, size_t>> Inventory::storeAnywhere(const Item& pickup, const size_t& height, const size_t& width) {
+    const Grid& shared = *grid_;
+    if (pickup.type_ == NONE || height == 0 || width == 0 || height > shared.rows_ || width > shared.cols_) {
+        return std::nullopt; // Nothing to place, or the footprint can never fit
+    }
+
+    // Find a spot before copying a shared grid, so a failed placement never copies
+    size_t cells = shared.rows_ * shared.cols_;
+    size_t first_free = shared.nextFree(shared.first_free_);
+    for (size_t index = first_free; index < cells; index = shared.nextFree(index + 1)) {
+        size_t row = index / shared.cols_;
+        size_t col = index % shared.cols_;
+        if (row + height > shared.rows_) {
+            break; // Every later candidate starts at this row or below
+        }
+        if (col + width > shared.cols_) {
+            continue;
+        }
+
+        bool fits = true;
+        for (size_t r = row; r < row + height && fits; ++r) {
+            fits = shared.isRangeFree(r * shared.cols_ + col, width);
+        }
+        if (!fits) {
+            continue;
+        }
+
+        Grid& grid = mutableGrid();
+        for (size_t r = row; r < row + height; ++r) {
+            grid.markRange(r * grid.cols_ + col, width);
+        }
+        grid.inventory_grid_[index] = pickup; // The top-left cell holds the item
+        grid.weight_ += pickup.weight_;
+        ++grid.item_count_;
+        grid.first_free_ = first_free;
+        return std::make_pair(row, col);
+    }
+    return std::nullopt;
+}
+
+/**
+    * @brief Stores items in the first free cells of the inventory grid.
+    * @param pickups The items to store.
+    * @return size_t The number of items stored.
+    * @post Items are placed in row-major order until the grid is full.
+*/
+size_t Inventory::storeBatch(const std::vector<Item>& pickups) {
+    if (grid_->nextFree(grid_->first_free_) == grid_->rows_ * grid_->cols_) {
+        return 0; // The grid is already full
+    }
+
+    Grid& grid = mutableGrid();
+    size_t cells = grid.rows_ * grid.cols_;
+    size_t stored = 0;
+    for (const Item& pickup : pickups) {
+        if (pickup.type_ == NONE) {
+            continue;
+        }
+        grid.first_free_ = grid.nextFree(grid.first_free_);
+        if (grid.first_free_ == cells) {
+            break; // The grid is full
+        }
+        grid.inventory_grid_[grid.first_free_] = pickup;
+        grid.markOccupied(grid.first_free_);
+        grid.weight_ += pickup.weight_;
+        ++grid.item_count_;
+        ++stored;
+    }
+    return stored;
+}
+
+/**
+    * @brief Copy constructor (copy-on-write), into the default memory resource.
     * @param rhs The Inventory object to copy from.
+    * @post The grid and equipped item are shared with rhs until either is modified,
+    *       if rhs uses the default resource, and copied into it otherwise.
 */
 Inventory::Inventory(const Inventory& rhs)
-    : inventory_grid_(rhs.inventory_grid_), equipped_(rhs.equipped_ ? new Item(*rhs.equipped_) : nullptr),
-      weight_(rhs.weight_), item_count_(rhs.item_count_) {}
+    : Inventory(rhs, std::pmr::get_default_resource()) {}
+
+/**
+    * @brief Allocator-extended copy constructor.
+    * @param rhs The Inventory object to copy from.
+    * @param resource The memory resource to allocate from.
+    * @post Shares rhs's contents if it uses the same resource, otherwise copies them into `resource`.
+*/
+Inventory::Inventory(const Inventory& rhs, std::pmr::memory_resource* resource)
+    : grid_(rhs.grid_), equipped_(rhs.equipped_), resource_(resource) {
+    if (rhs.resource_ != resource_) {
+        grid_ = allocateGrid(rhs.grid_.get());
+        equipped_ = rhs.equipped_ ? allocateItem(*rhs.equipped_) : nullptr;
+    }
+}
 
 /**
- * @brief Move constructor. 
+ * @brief Move constructor.
  * @param rhs The Inventory object to move from.
  * @post The rhs object is left in a valid but empty state.
 */
 Inventory::Inventory(Inventory&& rhs)
-    : inventory_grid_(std::move(rhs.inventory_grid_)),
-      equipped_(rhs.equipped_), weight_(rhs.weight_), item_count_(rhs.item_count_) {
+    : grid_(std::move(rhs.grid_)), equipped_(std::move(rhs.equipped_)), resource_(rhs.resource_) {
     // Reset rhs to a valid but empty state
+    rhs.grid_ = emptyGrid();
     rhs.equipped_ = nullptr;
-    rhs.weight_ = 0;
-    rhs.item_count_ = 0;
 }
 
 /**
-    * @brief Copy assignment operator.
+ * @brief Allocator-extended move constructor.
+ * @param rhs The Inventory object to move from.
+ * @param resource The memory resource to allocate from.
+ * @post Takes rhs's contents if it uses the same resource, otherwise copies them into `resource`.
+ *       The rhs object is left in a valid but empty state.
+*/
+Inventory::Inventory(Inventory&& rhs, std::pmr::memory_resource* resource)
+    : Inventory(std::move(rhs)) {
+    if (rhs.resource_ != resource) {
+        resource_ = resource;
+        grid_ = allocateGrid(grid_.get());
+        equipped_ = equipped_ ? allocateItem(*equipped_) : nullptr;
+    }
+}
+
+/**
+    * @brief Copy assignment operator (copy-on-write).
     * @param rhs The Inventory object to copy from.
     * @return Inventory& A reference to the assigned Inventory object.
-    * @post The current object is updated to be a copy of rhs.
+    * @post The current object shares rhs's grid and equipped item,
+    *       or holds copies of them if rhs uses a different memory resource.
 */
 Inventory& Inventory::operator=(const Inventory& rhs) {
     if (this != &rhs) {
-        inventory_grid_ = rhs.inventory_grid_;
-        if (equipped_) {
-            delete equipped_; // Delete the currently equipped item if it exists
+        if (rhs.resource_ == resource_) {
+            grid_ = rhs.grid_;
+            equipped_ = rhs.equipped_; // Releases the previously equipped item
+        } else {
+            grid_ = allocateGrid(rhs.grid_.get());
+            equipped_ = rhs.equipped_ ? allocateItem(*rhs.equipped_) : nullptr;
         }
-        equipped_ = rhs.equipped_ ? new Item(*rhs.equipped_) : nullptr; // Deep copy the equipped item
-        weight_ = rhs.weight_;
-        item_count_ = rhs.item_count_;
     }
     return *this;
 }
@@ -172,28 +510,23 @@ Inventory& Inventory::operator=(const Inventory& rhs) {
 */
 Inventory& Inventory::operator=(Inventory&& rhs) {
     if (this != &rhs) {
-        inventory_grid_ = std::move(rhs.inventory_grid_);
-        if (equipped_) {
-            delete equipped_; // Delete the currently equipped item if it exists
+        if (rhs.resource_ == resource_) {
+            grid_ = std::move(rhs.grid_);
+            equipped_ = std::move(rhs.equipped_); // Releases the previously equipped item
+        } else {
+            grid_ = allocateGrid(rhs.grid_.get());
+            equipped_ = rhs.equipped_ ? allocateItem(*rhs.equipped_) : nullptr;
         }
-        equipped_ = rhs.equipped_; // Move the equipped item
-        weight_ = rhs.weight_;
-        item_count_ = rhs.item_count_;
 
         // Reset rhs to a valid but empty state
+        rhs.grid_ = emptyGrid();
         rhs.equipped_ = nullptr;
-        rhs.weight_ = 0;
-        rhs.item_count_ = 0;
     }
     return *this;
 }
 
 /**
-    * @brief Destructor. 
-    * @post The equipped item is deleted if it exists.
+    * @brief Destructor.
+    * @post The grid and equipped item are released; the last owner deallocates them.
 */
-Inventory::~Inventory() {
-    if (equipped_) {
-        delete equipped_; // Delete the equipped item if it exists
-    }
-}
+Inventory::~Inventory() = default;
@@ -1,24 +1,105 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <utility>
 #include <vector>
 #include "Item.hpp"
 
 class Inventory {
     private: 
-        /** A dynamic grid for storing non-equipped items.
-        * Each outer vector represents a row in the grid,
-        * while the inner vectors represent columns within those rows.
+        /**
+        * @brief The immutable-once-shared contents of an Inventory's bag.
+        * Copies of an Inventory share one Grid until either copy is modified.
+        * A Grid and its containers are allocated from the owning Inventory's memory resource.
         */
-        std::vector<std::vector<Item>> inventory_grid_;
+        struct Grid {
+            // Constructs an empty 0x0 grid whose containers allocate from `resource`
+            explicit Grid(std::pmr::memory_resource* resource);
+
+            // Copies `rhs` into containers that allocate from `resource`
+            Grid(const Grid& rhs, std::pmr::memory_resource* resource);
+
+            /** A dense grid for storing non-equipped items.
+            * Cells are stored contiguously in row-major order, 
+            * so the item at (row, col) lives at index `row * cols_ + col`.
+            */
+            std::pmr::vector<Item> inventory_grid_;
+
+            // The number of rows and columns in `inventory_grid_`
+            size_t rows_ = 0;
+            size_t cols_ = 0;
+
+            /** An occupancy bitmap over `inventory_grid_`.
+            * Bit `i % 64` of word `i / 64` is set iff cell `i` holds a non-NONE item.
+            */
+            std::pmr::vector<uint64_t> occupied_;
+
+            // The total weight of all items in `inventory_grid_`
+            float weight_ = 0.0f; 
+
+            // The total number of non-empty items in `inventory_grid_`
+            size_t item_count_ = 0;
+
+            /** The lowest cell index that may still be free.
+            * Every cell below it is occupied, so free-slot searches start here.
+            */
+            size_t first_free_ = 0;
+
+            /**
+             * @brief Converts a (row, col) pair into an index of `inventory_grid_`.
+             * @throws std::out_of_range If the row or column is out of bounds.
+             */
+            size_t indexOf(const size_t& row, const size_t& col) const;
+
+            // Checks whether cell `index` is marked in `occupied_`
+            bool isOccupied(const size_t& index) const;
+
+            // Marks cell `index` as occupied in `occupied_`
+            void markOccupied(const size_t& index);
+
+            // Checks whether the `length` cells starting at `index` are all free
+            bool isRangeFree(const size_t& index, const size_t& length) const;
+
+            // Marks the `length` cells starting at `index` as occupied
+            void markRange(const size_t& index, const size_t& length);
+
+            /**
+             * @brief Finds the lowest free cell index at or after `from`.
+             * @return The index of the free cell, or `rows_ * cols_` if the grid is full.
+             */
+            size_t nextFree(const size_t& from) const;
+        };
+
+        // The (possibly shared) bag contents. Never nullptr.
+        std::shared_ptr<const Grid> grid_;
         
-        // A pointer to a dynamically allocated Item outside of the Player's bag
-        Item* equipped_;
+        // The (possibly shared) Item outside of the Player's bag, or nullptr
+        std::shared_ptr<const Item> equipped_;
+
+        // The memory resource this Inventory's grid and equipped item are allocated from
+        std::pmr::memory_resource* resource_;
 
-        // The total weight of all items in `inventory_grid_`
-        float weight_; 
+        /**
+         * @brief Allocates a Grid from `resource_`.
+         * @param source The Grid to copy, or nullptr for an empty 0x0 grid.
+         */
+        std::shared_ptr<Grid> allocateGrid(const Grid* source) const;
+
+        // Allocates a copy of `item` from `resource_`
+        std::shared_ptr<const Item> allocateItem(const Item& item) const;
+
+        /**
+         * @brief Retrieves a Grid that this Inventory may modify.
+         * @return A reference to `grid_`, first replaced by a private copy
+         *  if any other Inventory shares it.
+         */
+        Grid& mutableGrid();
 
-        // The total number of non-empty items in `inventory_grid_`
-        size_t item_count_;
+        // Retrieves the shared 0x0 Grid used by moved-from Inventories
+        static const std::shared_ptr<const Grid>& emptyGrid();
     public:
         /**
          * @brief Constructor with optional parameters for initialization.
@@ -26,46 +107,98 @@ class Inventory {
          *  Defaults to a 10x10 grid of default-constructed items, if none provided.
          * @param equipped A pointer to an Item object. 
          *  Defaults to nullptr, if none provided.
+         * @param resource The memory resource to allocate the grid and equipped item from.
+         *  Defaults to std::pmr::get_default_resource(), if none provided.
          * 
-         * @post Initializes members in the following way:
+         * @post Initializes a new, unshared Grid in the following way:
          * 1) Initializes `weight_` as the total weight of all items in `items` (excluding NONE type) 
          * 2) Initialies `item_count_` as the count of non-NONE items. 
+         * 3) Flattens `items` into a rows x cols grid, where cols is the length
+         *    of the longest row. Short rows are padded with NONE items.
          * 
          * NOTE: The `equipped` item is excluded from these calculations.
          */
         Inventory(
             const std::vector<std::vector<Item>>& items = 
                 std::vector(10, std::vector<Item>(10, Item{})),
-            Item* equipped = nullptr
+            Item* equipped = nullptr,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
             );
 
         /** 
-         * @brief Retrieves the value stored in `equipped_`
-         * @return The Item pointer stored in `equipped_`
+         * @brief Retrieves the value stored in `equipped_` for reading
+         * @return A const pointer to the equipped Item, or nullptr
+         * @note The equipped Item may be shared with copies of this Inventory, so it is
+         *  never handed out for writing. Change it by equipping a modified copy with equip().
+         *  The pointer is invalidated by the next equip() or discardEquipped().
          */
-        Item* getEquipped() const;
+        const Item* getEquipped() const;
 
         /**
          * @brief Equips a new item.
          * @param itemToEquip A pointer to the item to equip.
-         * @post Updates `equipped` to the specified item 
-         * without deallocating the original.
+         * @post Updates `equipped` to a copy of the specified item. The
+         * previous item is deallocated once no copy of this Inventory shares it.
          */
         void equip(Item* itemToEquip);
 
         /**
          * @brief Discards the currently equipped item.
-         * @post Deallocates the item pointed to by `equipped` 
-         * and sets `equipped` to nullptr, if `equipped` is not nullptr already.
+         * @post Sets `equipped` to nullptr. The item it pointed to is deallocated
+         * once no copy of this Inventory shares it.
          */
         void discardEquipped();
 
         /** 
-         * @brief Retrieves the value stored in `inventory_grid_`
-         * @return The vector<vector<Item>> value stored in `inventory_grid_`
+         * @brief Retrieves the contents of `inventory_grid_` as a 2D vector
+         * @return A vector<vector<Item>> copy of the grid, one inner vector per row
+         * @note Prefer `getGrid()` or `rowData()` when a copy is not needed.
          */
         std::vector<std::vector<Item>> getItems() const;
 
+        /**
+         * @brief Retrieves a const reference to the underlying row-major grid
+         * @return The flat vector of `rows() * cols()` items
+         * @note The reference is invalidated by the next modification of this Inventory.
+         */
+        const std::pmr::vector<Item>& getGrid() const;
+
+        /**
+         * @brief Retrieves a pointer to the first item of the specified row
+         * @param row A size_t parameter for the row index in the inventory grid.
+         * @return A pointer to `cols()` contiguous items making up the row
+         * @throws std::out_of_range If the row is out of bounds.
+         */
+        const Item* rowData(const size_t& row) const;
+
+        /**
+         * @brief Retrieves the number of rows in the inventory grid
+         * @return The number of rows in the grid
+         */
+        size_t rows() const;
+
+        /**
+         * @brief Retrieves the number of columns in the inventory grid
+         * @return The number of columns in the grid
+         */
+        size_t cols() const;
+
+        /**
+         * @brief Retrieves the memory resource this Inventory allocates from
+         * @return The value stored in `resource_`
+         */
+        std::pmr::memory_resource* getResource() const;
+
+        /**
+         * @brief Checks whether the cell at the specified row and column holds an item
+         * @param row A size_t parameter for the row index in the inventory grid.
+         * @param col A size_t parameter for the column index in the inventory grid.
+         * @return True if the cell holds a non-NONE item or is covered 
+         *  by a multi-cell item's footprint, false otherwise
+         * @throws std::out_of_range If the row or column is out of bounds.
+         */
+        bool isOccupied(const size_t& row, const size_t& col) const;
+
         /** 
          * @brief Retrieves the value stored in `weight_`
          * @return The float value stored in `weight_`
@@ -84,10 +217,10 @@ class Inventory {
          *
          * @param row A size_t parameter for the row index in the inventory grid.
          * @param col A size_t parameter for the column index in the inventory grid.
-         * @return The item at the specified row and column.
+         * @return A const reference to the item at the specified row and column.
          * @throws std::out_of_range If the row or column is out of bounds.
          */
-        Item at(const size_t& row, const size_t& col) const;
+        const Item& at(const size_t& row, const size_t& col) const;
 
         /**
          * @brief Stores an item at the specified row and column in the inventory grid.
@@ -97,22 +230,66 @@ class Inventory {
          * @param pickup A const ref. to the item to store at the specified location.
          * @return True if the item was successfully stored, false if the cell is already occupied.
          * 
-         * @post Updates `item_count_` and `weight_` if the Item is sucessfully added
+         * @post Updates `item_count_` and `weight_` if the Item is sucessfully added.
+         *  If the grid was shared with a copy of this Inventory, it is first
+         *  replaced by a private copy.
          * @throws std::out_of_range If the row or column is out of bounds.
          */
         bool store(const size_t& row, const size_t& col, const Item& pickup);
 
+        /**
+         * @brief Stores an item in the first free spot of the inventory grid,
+         * scanning in row-major order.
+         *
+         * @param pickup A const ref. to the item to store.
+         * @param height The number of rows the item's footprint covers. Defaults to 1.
+         * @param width The number of columns the item's footprint covers. Defaults to 1.
+         * @return The (row, col) of the footprint's top-left cell if the item was stored,
+         *  or std::nullopt if no free height x width block exists.
+         *
+         * @post On success, the item is stored at the top-left cell and every cell
+         *  of its footprint is marked occupied. `item_count_` and `weight_` are 
+         *  updated once for the item.
+         * @note Single-cell placement is O(1) amortized, since cells are never freed
+         *  and the search resumes from the lowest possibly-free cell.
+         */
+        std::optional<std::pair<size_t, size_t>> storeAnywhere(const Item& pickup, const size_t& height = 1, const size_t& width = 1);
+
+        /**
+         * @brief Stores each item in the first free cell of the inventory grid, in order.
+         *
+         * @param pickups A const ref. to the items to store.
+         * @return The number of items that were stored.
+         *
+         * @post Items are placed in row-major order until the grid is full;
+         *  any remaining items (and NONE items) are not stored.
+         */
+        size_t storeBatch(const std::vector<Item>& pickups);
+
         // Big Five
 
         /**
          * @brief Copy constructor for the Inventory class.
          * @param rhs A const l-value ref. to the Inventory object to copy.
-         * @post Creates a deep copy of `rhs`, 
-         *  including duplicating the dynamically 
-         *  allocated item in `equipped`.
+         * @post Allocates from the default memory resource, as pmr containers do on a
+         *  plain copy (select_on_container_copy_construction), so a copy never points into
+         *  an arena it may outlive. If `rhs` also uses the default resource, its grid and
+         *  equipped item are shared (copy-on-write): no items are copied until one of the
+         *  two Inventories is modified, so this costs two reference-count increments.
+         *  Otherwise they are copied. Use the allocator-extended overload to keep `rhs`'s resource.
          */
         Inventory(const Inventory& rhs);
 
+        /**
+         * @brief Allocator-extended copy constructor for the Inventory class.
+         * @param rhs A const l-value ref. to the Inventory object to copy.
+         * @param resource The memory resource the new Inventory allocates from.
+         * @post Shares `rhs`'s contents if it uses the same resource.
+         *  Otherwise copies them into `resource`, so that the new Inventory
+         *  never refers to memory owned by another resource.
+         */
+        Inventory(const Inventory& rhs, std::pmr::memory_resource* resource);
+
         /**
          * @brief Move constructor for the Inventory class.
          * @param rhs An r-value ref. to the Inventory object to move from.
@@ -120,21 +297,31 @@ class Inventory {
          * to the newly constructed Inventory object. 
          * 
          * Sets `rhs` to a valid but empty state.
-         * - All pointers are set to nullptr
-         * - All numerical values are set to 0
-         * - All containers are cleared to have size 0
+         * - `equipped` is set to nullptr
+         * - The grid is the shared, empty 0x0 grid
          */
         Inventory(Inventory&& rhs);
 
+        /**
+         * @brief Allocator-extended move constructor for the Inventory class.
+         * @param rhs An r-value ref. to the Inventory object to move from.
+         * @param resource The memory resource the new Inventory allocates from.
+         * @post Takes over `rhs`'s contents if it uses the same resource,
+         *  otherwise copies them into `resource`. In both cases `rhs`
+         *  is left in the same valid but empty state as the move constructor.
+         */
+        Inventory(Inventory&& rhs, std::pmr::memory_resource* resource);
+
         /**
          * @brief Copy assignment operator for the Inventory class.
          * @param rhs A const l-value ref. to the Inventory object to copy.
          * @return A reference to the updated Inventory object.
-         * @post Performs a deep copy of `rhs`, including 
-         * re-allocating and copying the item in `equipped`.
+         * @post Shares `rhs`'s grid and equipped item (copy-on-write) if both
+         * Inventories use the same memory resource, otherwise copies them 
+         * into this Inventory's resource.
          * 
          * NOTE: The resources of the overridden object
-         * should be destroyed.
+         * are destroyed once no other Inventory shares them.
          */
         Inventory& operator=(const Inventory& rhs);
 
@@ -143,12 +330,12 @@ class Inventory {
          * @param rhs An r-value ref. to the Inventory object to move from.
          * @return A reference to the updated Inventory object.
          * @post Transfers ownership of resources from `rhs` 
-         * to the newly constructed Inventory object. 
+         * to the newly constructed Inventory object, or copies them into
+         * this Inventory's memory resource if `rhs` uses a different one.
          * 
          * Sets `rhs` to a valid but empty state.
-         * - All pointers are set to nullptr
-         * - All numerical values are set to 0
-         * - All containers are cleared to have size 0
+         * - `equipped` is set to nullptr
+         * - The grid is the shared, empty 0x0 grid
          * 
          * NOTE: The resources of the overridden object
          * should be destroyed.
@@ -157,7 +344,7 @@ class Inventory {
 
         /**
          * @brief Destructor for the Inventory class.
-         * @post Deallocates any dynamically allocated resources.
+         * @post Deallocates the grid and equipped item, if no copy still shares them.
          */
         ~Inventory();
 };
\ No newline at end of file
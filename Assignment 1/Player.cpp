@@ -15,11 +15,20 @@
 Player::Player(const std::string& name, const Inventory& inventory)
     : name_(name), inventory_(inventory) {} // Initialize name and inventory
 
+/**
+    * @brief Constructs a new Player object whose inventory allocates from a memory resource.
+    * @param name A const reference to the player's name.
+    * @param inventory A const reference to the player's inventory.
+    * @param resource The memory resource for the player's inventory.
+*/
+Player::Player(const std::string& name, const Inventory& inventory, std::pmr::memory_resource* resource)
+    : inventory_(inventory, resource), name_(name) {} // Initialize name and inventory
+
 /**
     * @brief Gets the player's name.
-    * @return std::string The player's name.
+    * @return const std::string& The player's name.
 */
-std::string Player::getName() const {
+const std::string& Player::getName() const {
     return name_; // Return the player's name
 }
 
@@ -38,6 +47,14 @@ Inventory& Player::getInventoryRef() {
 Player::Player(const Player& rhs)
     : name_(rhs.name_), inventory_(rhs.inventory_) {} // Copy name and inventory from rhs
 
+/**
+    * @brief Allocator-extended copy constructor.
+    * @param rhs The Player object to copy from.
+    * @param resource The memory resource for the new player's inventory.
+*/
+Player::Player(const Player& rhs, std::pmr::memory_resource* resource)
+    : inventory_(rhs.inventory_, resource), name_(rhs.name_) {} // Copy name and inventory from rhs
+
 /**
     * @brief Move constructor.
     * @param rhs The Player object to move from.
@@ -49,6 +66,18 @@ Player::Player(Player&& rhs)
     rhs.name_ = ""; // Clear the name of rhs
 }
 
+/**
+    * @brief Allocator-extended move constructor.
+    * @param rhs The Player object to move from.
+    * @param resource The memory resource for the new player's inventory.
+    * @post The rhs object is left in a valid but empty state.
+*/
+Player::Player(Player&& rhs, std::pmr::memory_resource* resource)
+    : inventory_(std::move(rhs.inventory_), resource), name_(std::move(rhs.name_)) {
+    // Reset rhs to a valid but empty state
+    rhs.name_ = ""; // Clear the name of rhs
+}
+
 /**
     * @brief Copy assignment operator.
     * @param rhs The Player object to copy from.
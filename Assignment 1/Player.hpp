@@ -5,6 +5,9 @@
 class Player {
     private:
         Inventory inventory_;
+
+        // Allocated from the default resource (not the Inventory's) if too long for the
+        // small-string buffer, since getName() hands out a plain std::string
         std::string name_;
 
     public:
@@ -15,12 +18,20 @@ class Player {
          *      If none provided, default value of a default constructed Inventory
          */
         Player(const std::string& name, const Inventory& inventory = Inventory());
+
+        /**
+         * @brief Constructs a Player whose Inventory allocates from the given memory resource.
+         * @param name A const. string reference to be the player name
+         * @param inventory A const ref. to an Inventory to copy into `resource`
+         * @param resource The memory resource for the Player's Inventory
+         */
+        Player(const std::string& name, const Inventory& inventory, std::pmr::memory_resource* resource);
         
         /**
          * @brief Gets the name of the Player
-         * @return The string value stored in name
+         * @return A const reference to the string value stored in name
          */
-        std::string getName() const;
+        const std::string& getName() const;
 
         /**
          * @brief Exposes a reference to interact with the Player's Inventory.
@@ -33,9 +44,21 @@ class Player {
        /**
          * @brief Copy constructor for the Player class.
          * @param rhs A const l-value ref. to the Player object to copy.
-         * @post Creates a deep copy of `rhs`
+         * @post Copies `rhs`'s name. The Inventory allocates from the default memory
+         *  resource, like any plain pmr copy, and shares `rhs`'s contents copy-on-write
+         *  if they are there too, so no items are copied until either Player's
+         *  Inventory is modified.
          */
         Player(const Player& rhs);
+
+        /**
+         * @brief Allocator-extended copy constructor for the Player class.
+         * @param rhs A const l-value ref. to the Player object to copy.
+         * @param resource The memory resource for the new Player's Inventory
+         * @post As the copy constructor, except the Inventory contents are
+         *  copied into `resource` if `rhs` uses a different one.
+         */
+        Player(const Player& rhs, std::pmr::memory_resource* resource);
         
          /**
          * @brief Move constructor for the Player class.
@@ -45,12 +68,21 @@ class Player {
          */
         Player(Player&& rhs);
 
+        /**
+         * @brief Allocator-extended move constructor for the Player class.
+         * @param rhs An r-value ref. to a Player object to move from.
+         * @param resource The memory resource for the new Player's Inventory
+         * @post As the move constructor, except the Inventory contents are
+         *  copied into `resource` if `rhs` uses a different one.
+         */
+        Player(Player&& rhs, std::pmr::memory_resource* resource);
+
         /**
          * @brief Copy assignment operator for the Player class.
          * @param rhs A const l-value ref. to the Player object to copy.
          * @return A reference to the updated Player object.
-         * @post Performs a deep copy of `rhs`, including 
-         * re-allocating and copying the Inventory and ID.
+         * @post Copies `rhs`'s name and shares its Inventory contents
+         * copy-on-write, as in the copy constructor.
          */
         Player& operator=(const Player& rhs);
 
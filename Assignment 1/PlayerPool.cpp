@@ -0,0 +1,86 @@
+#include "PlayerPool.hpp"
+
+/**
+    * @brief Constructs an empty PlayerPool.
+    * @param resource The memory resource to allocate from.
+*/
+PlayerPool::PlayerPool(std::pmr::memory_resource* resource)
+    : slots_{resource}, free_slots_{resource}, resource_{resource} {}
+
+/**
+    * @brief Gets the pool shared by default-constructed Guilds.
+    * @return std::shared_ptr<PlayerPool> The process-wide pool.
+*/
+std::shared_ptr<PlayerPool> PlayerPool::shared() {
+    static std::shared_ptr<PlayerPool> pool = std::make_shared<PlayerPool>();
+    return pool;
+}
+
+/**
+    * @brief Places a Player in a recycled slot, or appends a new one.
+    * @param player The Player to copy or move from.
+    * @return PlayerHandle The handle of the slot used.
+*/
+template <class P>
+PlayerHandle PlayerPool::emplace(P&& player) {
+    if (free_slots_.empty()) {
+        slots_.emplace_back(std::in_place, std::forward<P>(player), resource_); // Growing a deque never moves existing Players
+        return slots_.size() - 1;
+    }
+    PlayerHandle handle = free_slots_.back();
+    free_slots_.pop_back();
+    slots_[handle].emplace(std::forward<P>(player), resource_);
+    return handle;
+}
+
+/**
+    * @brief Moves a Player into the pool.
+    * @param player The Player to move from.
+    * @return PlayerHandle The handle of the pooled Player.
+*/
+PlayerHandle PlayerPool::acquire(Player&& player) {
+    return emplace(std::move(player));
+}
+
+/**
+    * @brief Copies a Player into the pool.
+    * @param player The Player to copy.
+    * @return PlayerHandle The handle of the pooled Player.
+*/
+PlayerHandle PlayerPool::acquire(const Player& player) {
+    return emplace(player);
+}
+
+/**
+    * @brief Destroys a pooled Player and recycles its slot.
+    * @param handle The handle to release.
+*/
+void PlayerPool::release(const PlayerHandle& handle) {
+    slots_[handle].reset();
+    free_slots_.push_back(handle);
+}
+
+/**
+    * @brief Gets the Player behind a handle.
+    * @param handle A live handle.
+    * @return Player& The pooled Player.
+*/
+Player& PlayerPool::get(const PlayerHandle& handle) {
+    return *slots_[handle];
+}
+
+/**
+    * @brief Gets the number of live Players in the pool.
+    * @return size_t The number of live handles.
+*/
+size_t PlayerPool::size() const {
+    return slots_.size() - free_slots_.size();
+}
+
+/**
+    * @brief Gets the memory resource the pool allocates from.
+    * @return std::pmr::memory_resource* The pool's memory resource.
+*/
+std::pmr::memory_resource* PlayerPool::resource() const {
+    return resource_;
+}
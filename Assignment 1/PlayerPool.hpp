@@ -0,0 +1,92 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include "Player.hpp"
+
+/**
+ * @brief A stable index into a PlayerPool.
+ */
+using PlayerHandle = size_t;
+
+class PlayerPool {
+    private:
+        /**
+        * @brief Storage for every Player in the pool, indexed by handle.
+        * A deque never relocates its elements when it grows, so a Player
+        * stays at the same address for as long as its handle is live.
+        * Released slots are left empty (std::nullopt) until they are reused.
+        */
+        std::pmr::deque<std::optional<Player>> slots_;
+
+        // Handles of released slots, reused before `slots_` grows
+        std::pmr::vector<PlayerHandle> free_slots_;
+
+        // The memory resource for the slots and every pooled Player's Inventory
+        std::pmr::memory_resource* resource_;
+
+        // Places `player` in a free slot (or a new one) and returns its handle
+        template <class P>
+        PlayerHandle emplace(P&& player);
+    public:
+        /**
+         * @brief Constructs an empty PlayerPool.
+         * @param resource The memory resource to allocate slots and pooled Players' Inventories from.
+         *      Defaults to std::pmr::get_default_resource(), if none provided.
+         * @note Passing a std::pmr::monotonic_buffer_resource or pool resource
+         *      places a whole guild's members in one arena.
+         */
+        PlayerPool(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        /**
+         * @brief Retrieves the process-wide pool shared by default-constructed Guilds.
+         * @return A shared_ptr to the shared PlayerPool.
+         * @note Guilds that share a pool can transfer players by handle alone.
+         */
+        static std::shared_ptr<PlayerPool> shared();
+
+        /**
+         * @brief Moves a Player into the pool.
+         * @param player An r-value ref. to the Player to move from.
+         * @return The handle of the pooled Player.
+         * @post `player` is left in a valid but empty state. Its Inventory contents
+         *      are copied into the pool's resource if it used a different one.
+         */
+        PlayerHandle acquire(Player&& player);
+
+        /**
+         * @brief Copies a Player into the pool.
+         * @param player A const l-value ref. to the Player to copy.
+         * @return The handle of the pooled Player, whose Inventory allocates from the pool's resource.
+         */
+        PlayerHandle acquire(const Player& player);
+
+        /**
+         * @brief Destroys the Player behind a handle and recycles its slot.
+         * @param handle A live handle returned by acquire().
+         * @post `handle` is no longer valid until acquire() hands it out again.
+         */
+        void release(const PlayerHandle& handle);
+
+        /**
+         * @brief Retrieves the Player behind a handle.
+         * @param handle A live handle returned by acquire().
+         * @return A reference to the pooled Player, stable until the handle is released.
+         */
+        Player& get(const PlayerHandle& handle);
+
+        /**
+         * @brief Retrieves the number of live Players in the pool.
+         * @return The count of acquired, unreleased handles.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Retrieves the memory resource the pool allocates from.
+         * @return The value stored in `resource_`.
+         */
+        std::pmr::memory_resource* resource() const;
+};
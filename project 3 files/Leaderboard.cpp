@@ -1,9 +1,171 @@
 #include "Leaderboard.hpp"
+#include "PlayerFile.hpp"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#ifdef PERF_COUNTERS
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 using namespace std::chrono;
 
+namespace {
+
+/**
+ * @brief Runs fn(0), ..., fn(count - 1) concurrently, using the calling thread for fn(0).
+ *
+ * @param count The number of tasks (and threads) to run.
+ * @param fn A callable taking the task index.
+ * @post Returns once every task has finished.
+*/
+template <class Fn>
+void parallelFor(size_t count, Fn fn) {
+    std::vector<std::thread> workers;
+    workers.reserve(count > 0 ? count - 1 : 0);
+    for (size_t t = 1; t < count; t++) {
+        workers.emplace_back(fn, t);
+    }
+    if (count > 0) {
+        fn(0);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+#ifdef PERF_COUNTERS
+/**
+ * @brief A group of user-space hardware counters for the calling thread, via perf_event_open().
+ * Events the kernel refuses (no PMU, or perf_event_paranoid too strict) are left out.
+*/
+class PerfCounters {
+public:
+    PerfCounters() {
+        const std::pair<const char*, uint64_t> events[] = {
+            {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+            {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+            {"cache-misses", PERF_COUNT_HW_CACHE_MISSES},
+            {"branch-misses", PERF_COUNT_HW_BRANCH_MISSES},
+        };
+        for (const auto& [name, config] : events) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config;
+            attr.disabled = fds_.empty(); // Members follow the leader
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            int leader = fds_.empty() ? -1 : fds_.front();
+            int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+            if (fd >= 0) {
+                fds_.push_back(fd);
+                names_.push_back(name);
+            }
+        }
+    }
+
+    ~PerfCounters() {
+        for (int fd : fds_) close(fd);
+    }
+
+    void enable() {
+        if (!fds_.empty()) ioctl(fds_.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    void disable() {
+        if (!fds_.empty()) ioctl(fds_.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    // Adds each event's count to `counters`
+    void read(std::unordered_map<std::string, uint64_t>& counters) const {
+        if (fds_.empty()) return;
+        std::vector<uint64_t> values(1 + fds_.size()); // { nr, value[nr] }
+        size_t size = values.size() * sizeof(uint64_t);
+        if (::read(fds_.front(), values.data(), size) != static_cast<ssize_t>(size)) return;
+        for (size_t i = 0; i < names_.size(); i++) {
+            counters[names_[i]] = values[i + 1];
+        }
+    }
+
+private:
+    std::vector<int> fds_;
+    std::vector<const char*> names_;
+};
+#endif
+
+/**
+ * @brief Times the phases of one ranking on steady_clock & builds its RankingResult.
+ *
+ * Each lap() charges the time since the previous one to a phase. Fetches are bracketed
+ * by pause() & resume(), which charge them to fetch_ and keep them out of elapsed_
+ * (and out of the hardware counters, when PERF_COUNTERS is defined).
+*/
+class PhaseTimer {
+public:
+    using Phase = double RankingPhases::*;
+
+    PhaseTimer() : mark_(steady_clock::now()) {
+#ifdef PERF_COUNTERS
+        counters_.enable();
+#endif
+    }
+
+    // Charges the time since the last mark to `phase`
+    void lap(Phase phase) {
+        auto now = steady_clock::now();
+        phases_.*phase += duration<double, std::milli>(now - mark_).count();
+        mark_ = now;
+    }
+
+    // Charges the time since the last mark to `phase`, then stops counting until resume()
+    void pause(Phase phase) {
+#ifdef PERF_COUNTERS
+        counters_.disable();
+#endif
+        lap(phase);
+    }
+
+    // Charges the time since pause() to fetch_
+    void resume() {
+        lap(&RankingPhases::fetch_);
+#ifdef PERF_COUNTERS
+        counters_.enable();
+#endif
+    }
+
+    // Charges the time since the last mark to `phase`, and hands the phases to a RankingResult
+    RankingResult result(Phase phase, std::vector<Player>&& top, std::unordered_map<size_t, size_t>&& cutoffs = {}) {
+        lap(phase);
+        double elapsed = phases_.select_ + phases_.sort_ + phases_.copy_;
+        RankingResult result(std::move(top), std::move(cutoffs), elapsed);
+        result.phases_ = phases_;
+#ifdef PERF_COUNTERS
+        counters_.disable();
+        counters_.read(result.counters_);
+#endif
+        return result;
+    }
+
+private:
+#ifdef PERF_COUNTERS
+    PerfCounters counters_; // Opened before mark_ is taken, so opening isn't timed
+#endif
+    steady_clock::time_point mark_;
+    RankingPhases phases_;
+};
+
+} // namespace
+
 /**
  * @brief Constructor for RankingResult with top players, cutoffs, and elapsed time.
  *
@@ -19,88 +181,611 @@ RankingResult::RankingResult(const std::vector<Player>& top,
                              double elapsed)
     : top_(top), cutoffs_(cutoffs), elapsed_(elapsed) {}
 
+/**
+ * @brief Constructs a RankingResult by taking over the top players and cutoffs.
+ *
+ * @param top Vector of top-ranked Player objects, in sorted order, to move from.
+ * @param cutoffs Map of player count thresholds to minimum level cutoffs, to move from.
+ * @param elapsed Time taken to calculate the ranking, in ms.
+*/
+RankingResult::RankingResult(std::vector<Player>&& top,
+                             std::unordered_map<size_t, size_t>&& cutoffs,
+                             double elapsed)
+    : top_(std::move(top)), cutoffs_(std::move(cutoffs)), elapsed_(elapsed) {}
+
 namespace Offline {
 
-RankingResult heapRank(std::vector<Player>& players) {
-    auto start = high_resolution_clock::now();
+void makeHeap(PlayerIt first, PlayerIt last, const size_t& arity) {
+    size_t heap_size = std::distance(first, last);
+    if (heap_size < 2) return;
+
+    // Percolate down every internal node, from the last parent up to the root
+    for (size_t parent = (heap_size - 2) / arity + 1; parent-- > 0;) {
+        siftDown(first, last, parent, arity);
+    }
+}
+
+void siftDown(PlayerIt first, PlayerIt last, size_t hole, const size_t& arity) {
+    size_t heap_size = std::distance(first, last);
+    Player value = std::move(*(first + hole));
+
+    while (true) {
+        size_t child = arity * hole + 1;
+        if (child >= heap_size) break;
+
+        // Find the smallest of up to `arity` contiguous children
+        size_t smallest = child;
+        size_t last_child = std::min(child + arity, heap_size);
+        for (size_t c = child + 1; c < last_child; c++) {
+            if ((first + c)->level_ < (first + smallest)->level_) {
+                smallest = c;
+            }
+        }
+
+        if (!((first + smallest)->level_ < value.level_)) break;
+
+        // Move the child up into the hole rather than swapping
+        *(first + hole) = std::move(*(first + smallest));
+        hole = smallest;
+    }
+    *(first + hole) = std::move(value);
+}
+
+void replaceTop(PlayerIt first, PlayerIt last, Player& target, const size_t& arity) {
+    if (first == last) return;
+
+    std::swap(*first, target);
+    siftDown(first, last, 0, arity);
+}
+
+RankingResult heapRank(std::vector<Player>& players, double fraction, size_t arity) {
+    PhaseTimer timer;
     
     //Calculate the number of top players to select
-    size_t top_count = std::floor(0.1 * players.size());
+    size_t top_count = std::floor(std::clamp(fraction, 0.0, 1.0) * players.size());
+    arity = std::max<size_t>(arity, 2);
     std::vector<Player> top;
     
     if (top_count > 0) {
+        auto heap_end = players.begin() + top_count;
+
         // Create a min-heap of the first top_count elements
-        std::make_heap(players.begin(), players.begin() + top_count, std::greater<Player>());
+        makeHeap(players.begin(), heap_end, arity);
 
-        // For remaining elements, compare with root of heap
+        // For remaining elements, swap them with the root of the heap if they beat it
         for (size_t i = top_count; i < players.size(); i++) {
             if (players[i] > players[0]) {
-                std::swap(players[0], players[i]);
-                std::make_heap(players.begin(), players.begin() + top_count, std::greater<Player>());
+                replaceTop(players.begin(), heap_end, players[i], arity);
             }
         }
+        timer.lap(&RankingPhases::select_);
+
+        // Heapsort the prefix: each pop moves the minimum just past the shrinking heap,
+        // leaving the prefix in descending order
+        for (size_t remaining = top_count - 1; remaining > 0; remaining--) {
+            std::swap(players[0], players[remaining]);
+            siftDown(players.begin(), players.begin() + remaining, 0, arity);
+        }
+        timer.lap(&RankingPhases::sort_);
+
+        top.assign(std::make_move_iterator(std::make_reverse_iterator(heap_end)),
+                   std::make_move_iterator(players.rend()));
+    }
+
+    return timer.result(&RankingPhases::copy_, std::move(top));
+}
+
+/**
+ * @brief Player accessor used by the selection/sorting templates below.
+*/
+inline size_t levelOf(const Player& player) {
+    return player.level_;
+}
+
+/**
+ * @brief A 16-byte stand-in for a Player while ranking: its level and its index in the input.
+ * Moving and comparing these touches a quarter of the memory a Player does, and never its name.
+*/
+struct RankKey {
+    size_t level_;
+    size_t index_;
+};
 
-        // Extract and sort the top elements
-        top.assign(players.begin(), players.begin() + top_count);
-        std::sort(top.begin(), top.end());
+/**
+ * @brief RankKey accessor used by the selection/sorting templates below.
+*/
+inline size_t levelOf(const RankKey& key) {
+    return key.level_;
+}
+
+/**
+ * @brief Computes floor(log2(n)) for n > 0, used to bound recursion depth.
+*/
+inline size_t floorLog2(size_t n) {
+    size_t log = 0;
+    while (n >>= 1) log++;
+    return log;
+}
+
+/**
+ * @brief Sorts items[left..right] by ascending level with insertion sort.
+ *
+ * @param items Vector to sort.
+ * @param left Start index of the range (inclusive).
+ * @param right End index of the range (inclusive). An empty range (right < left) is a no-op.
+*/
+template <class T>
+void insertionSort(std::vector<T>& items, size_t left, size_t right) {
+    for (size_t i = left + 1; i <= right && i < items.size(); i++) {
+        T value = std::move(items[i]);
+        size_t j = i;
+        while (j > left && levelOf(items[j - 1]) > levelOf(value)) {
+            items[j] = std::move(items[j - 1]);
+            j--;
+        }
+        items[j] = std::move(value);
     }
+}
 
-    auto end = high_resolution_clock::now();
-    return RankingResult(top, {}, duration_cast<milliseconds>(end - start).count());
+/**
+ * @brief Returns the median of three levels.
+*/
+inline size_t medianOf3(size_t a, size_t b, size_t c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
 }
 
 /**
- * @brief Partitions players around pivot for quickselect algorithm.
+ * @brief Chooses a pivot level for items[left..right]: the median of the first, middle
+ * and last levels, or for large ranges, Tukey's ninther (the median of three such medians).
  *
- * @param players Vector to partition.
- * @param left Start index of partition range.
- * @param right End index of partition range.
- * @return Index of pivot after partitioning.
-*/
-size_t partition(std::vector<Player>& players, size_t left, size_t right) {
-    Player pivot = players[right];
-    size_t i = left;
-    
-    for (size_t j = left; j < right; j++) {
-        if (players[j] > pivot) {
-            std::swap(players[i], players[j]);
-            i++;
+ * @return A level that occurs in items[left..right].
+*/
+template <class T>
+size_t choosePivot(const std::vector<T>& items, size_t left, size_t right) {
+    size_t mid = left + (right - left) / 2;
+    auto at = [&](size_t i) { return levelOf(items[i]); };
+
+    if (right - left < 128) {
+        return medianOf3(at(left), at(mid), at(right));
+    }
+    size_t step = (right - left) / 8;
+    return medianOf3(
+        medianOf3(at(left), at(left + step), at(left + 2 * step)),
+        medianOf3(at(mid - step), at(mid), at(mid + step)),
+        medianOf3(at(right - 2 * step), at(right - step), at(right)));
+}
+
+/**
+ * @brief Three-way partitioning of items[left..right] around a pivot level.
+ *
+ * Afterwards, for `before` = std::greater<size_t>() (descending):
+ *   items[left..lt)   have levels before the pivot (ie. greater)
+ *   items[lt..gt]     have levels equal to the pivot
+ *   items(gt..right]  have levels after the pivot (ie. smaller)
+ *
+ * Runs of equal levels are gathered in one pass, so many duplicate levels
+ * shrink the range instead of degrading it. This is the Lomuto form of the
+ * Dutch-flag partition: items after the pivot are never moved, so selecting a
+ * small top fraction only swaps the few players that belong in it.
+ *
+ * @param pivot A level that occurs in items[left..right].
+ * @return The pair {lt, gt} bounding the (non-empty) run equal to the pivot.
+*/
+template <class T, class Before>
+std::pair<size_t, size_t> partition3(std::vector<T>& items, size_t left, size_t right, size_t pivot, Before before) {
+    size_t lt = left;   // End of the "before" run
+    size_t eq = left;   // End of the "equal" run
+
+    for (size_t i = left; i <= right; i++) {
+        size_t level = levelOf(items[i]);
+        if (before(level, pivot)) {
+            // Rotate items[i] -> lt, items[lt] -> eq and items[eq] -> i (three moves fewer than two swaps)
+            T moved = std::move(items[i]);
+            if (i != eq) items[i] = std::move(items[eq]);
+            if (eq != lt) items[eq] = std::move(items[lt]);
+            items[lt++] = std::move(moved);
+            eq++;
+        } else if (!before(pivot, level)) {
+            std::swap(items[eq++], items[i]);
         }
     }
-    std::swap(players[i], players[right]);
-    return i;
+    return {lt, eq - 1};
+}
+
+template <class T>
+void select(std::vector<T>& items, size_t left, size_t right, size_t k, size_t depth_limit);
+
+/**
+ * @brief Computes a median-of-medians pivot for items[left..right], which is guaranteed
+ * to have at least ~30% of the range on either side of it.
+ *
+ * Sorts each group of 5, gathers the group medians at the front of the range,
+ * then selects their median.
+ *
+ * @return A level that occurs in items[left..right].
+ * @post items[left..right] is reordered.
+*/
+template <class T>
+size_t medianOfMedians(std::vector<T>& items, size_t left, size_t right) {
+    if (right - left < 5) {
+        insertionSort(items, left, right);
+        return levelOf(items[left + (right - left) / 2]);
+    }
+
+    size_t medians = left;
+    for (size_t group = left; group <= right; group += 5) {
+        size_t group_right = std::min(group + 4, right);
+        insertionSort(items, group, group_right);
+        std::swap(items[medians++], items[group + (group_right - group) / 2]);
+    }
+
+    size_t mid = left + (medians - 1 - left) / 2;
+    select(items, left, medians - 1, mid, 2 * floorLog2(medians - left));
+    return levelOf(items[mid]);
 }
 
-RankingResult quickSelectRank(std::vector<Player>& players) {
-    auto start = high_resolution_clock::now();
+/**
+ * @brief Introselect: rearranges items[left..right] so that items[k] holds the level that would
+ * be there if the range were sorted in descending order, with every item before it having a
+ * greater or equal level and every item after it a lesser or equal level.
+ *
+ * Uses ninther/median-of-3 pivots and three-way partitioning, and switches to median-of-medians
+ * pivots once `depth_limit` partitioning rounds have passed, which bounds the worst case at O(N).
+ *
+ * @param items Vector to partition.
+ * @param left Start index of partition range (inclusive).
+ * @param right End index of partition range (inclusive).
+ * @param k The index to select, in [left, right].
+ * @param depth_limit The number of rounds allowed before switching to median-of-medians pivots.
+*/
+template <class T>
+void select(std::vector<T>& items, size_t left, size_t right, size_t k, size_t depth_limit) {
+    while (right > left) {
+        size_t pivot = depth_limit > 0 ? choosePivot(items, left, right) : medianOfMedians(items, left, right);
+        if (depth_limit > 0) depth_limit--;
+
+        auto [lt, gt] = partition3(items, left, right, pivot, std::greater<size_t>());
+        if (k < lt) {
+            right = lt - 1;
+        } else if (k > gt) {
+            left = gt + 1;
+        } else {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Introsort: sorts items[left..right] by ascending level.
+ *
+ * Uses three-way quicksort with ninther/median-of-3 pivots, recursing into the smaller side
+ * (O(log N) stack) and finishing small ranges with insertion sort. Falls back to heapsort once
+ * `depth_limit` partitioning rounds have passed, which bounds the worst case at O(N log N).
+ *
+ * @param items Vector to sort.
+ * @param left Start index of the range (inclusive).
+ * @param right End index of the range (inclusive).
+ * @param depth_limit The number of rounds allowed before switching to heapsort.
+*/
+template <class T>
+void quickSort(std::vector<T>& items, size_t left, size_t right, size_t depth_limit) {
+    const size_t INSERTION_CUTOFF = 16;
+    auto byLevel = [](const T& a, const T& b) { return levelOf(a) < levelOf(b); };
+
+    while (right > left && right - left >= INSERTION_CUTOFF) {
+        if (depth_limit == 0) {
+            std::make_heap(items.begin() + left, items.begin() + right + 1, byLevel);
+            std::sort_heap(items.begin() + left, items.begin() + right + 1, byLevel);
+            return;
+        }
+        depth_limit--;
+
+        size_t pivot = choosePivot(items, left, right);
+        auto [lt, gt] = partition3(items, left, right, pivot, std::less<size_t>());
+
+        if (lt - left < right - gt) {
+            if (lt > left) quickSort(items, left, lt - 1, depth_limit);
+            left = gt + 1;
+        } else {
+            if (gt < right) quickSort(items, gt + 1, right, depth_limit);
+            if (lt == left) return;
+            right = lt - 1;
+        }
+    }
+    insertionSort(items, left, right);
+}
+
+RankingResult quickSelectRank(std::vector<Player>& players, double fraction) {
+    PhaseTimer timer;
     
-    size_t top_count = std::floor(0.1 * players.size());
+    size_t top_count = std::floor(std::clamp(fraction, 0.0, 1.0) * players.size());
     std::vector<Player> top;
     
     if (top_count > 0) {
-        size_t left = 0;
-        size_t right = players.size() - 1;
-        
-        //Quickselect algorithm to find the top elements
-        while (left <= right) {
-            size_t pivot_idx = partition(players, left, right);
-            
-            if (pivot_idx == top_count - 1) {
-                break;
-            } else if (pivot_idx < top_count - 1) {
-                left = pivot_idx + 1;
+        size_t depth_limit = 2 * floorLog2(players.size());
+
+        // Quickselect until the top elements fill players[0, top_count)
+        if (top_count < players.size()) {
+            select(players, 0, players.size() - 1, top_count - 1, depth_limit);
+        }
+        timer.lap(&RankingPhases::select_);
+
+        // Quicksort just the selected prefix, then extract it
+        quickSort(players, 0, top_count - 1, depth_limit);
+        timer.lap(&RankingPhases::sort_);
+        top.assign(std::make_move_iterator(players.begin()), std::make_move_iterator(players.begin() + top_count));
+    }
+
+    return timer.result(&RankingPhases::copy_, std::move(top));
+}
+
+RankingResult keyRank(const std::vector<Player>& players, double fraction) {
+    PhaseTimer timer;
+
+    size_t top_count = std::floor(std::clamp(fraction, 0.0, 1.0) * players.size());
+    std::vector<Player> top;
+
+    if (top_count > 0) {
+        std::vector<RankKey> keys(players.size());
+        for (size_t i = 0; i < players.size(); i++) {
+            keys[i] = {players[i].level_, i};
+        }
+        size_t depth_limit = 2 * floorLog2(keys.size());
+
+        // Same introselect/introsort as quickSelectRank, over the keys alone
+        if (top_count < keys.size()) {
+            select(keys, 0, keys.size() - 1, top_count - 1, depth_limit);
+        }
+        timer.lap(&RankingPhases::select_);
+        quickSort(keys, 0, top_count - 1, depth_limit);
+        timer.lap(&RankingPhases::sort_);
+
+        // Only the winners' Players are ever touched
+        top.reserve(top_count);
+        for (size_t i = 0; i < top_count; i++) {
+            top.push_back(players[keys[i].index_]);
+        }
+    }
+
+    return timer.result(&RankingPhases::copy_, std::move(top));
+}
+
+RankingResult countingRank(std::vector<Player>& players, double fraction) {
+    PhaseTimer timer;
+
+    size_t top_count = std::floor(std::clamp(fraction, 0.0, 1.0) * players.size());
+    if (top_count == 0) {
+        return timer.result(&RankingPhases::select_, {});
+    }
+
+    auto [lowest, highest] = std::minmax_element(players.begin(), players.end());
+    size_t min_level = lowest->level_;
+    size_t range = highest->level_ - min_level;
+
+    // A histogram much larger than the input costs more than it saves
+    if (range >= std::max(COUNTING_RANGE_LIMIT, players.size())) {
+        return quickSelectRank(players, fraction);
+    }
+
+    // Histogram of levels, offset by the minimum
+    std::vector<size_t> counts(range + 1, 0);
+    for (const Player& player : players) {
+        counts[player.level_ - min_level]++;
+    }
+
+    // Walk down from the highest level until the top_count players are covered
+    size_t cutoff = range;
+    size_t above = 0;
+    while (above + counts[cutoff] < top_count) {
+        above += counts[cutoff--];
+    }
+    size_t tied = top_count - above; // Players at the cutoff level to keep
+
+    // Turn the counts above the cutoff into each level's first index in the ascending result
+    size_t next = tied;
+    for (size_t level = cutoff + 1; level <= range; level++) {
+        size_t count = counts[level];
+        counts[level] = next;
+        next += count;
+    }
+    timer.lap(&RankingPhases::select_);
+
+    // Move each winner straight into its sorted position in one pass, so there's no sort phase
+    std::vector<Player> top(top_count);
+    size_t tied_placed = 0;
+    for (Player& player : players) {
+        size_t level = player.level_ - min_level;
+        if (level > cutoff) {
+            top[counts[level]++] = std::move(player);
+        } else if (level == cutoff && tied_placed < tied) {
+            top[tied_placed++] = std::move(player);
+        }
+    }
+
+    return timer.result(&RankingPhases::copy_, std::move(top));
+}
+
+RankingResult parallelRank(std::vector<Player>& players, double fraction, size_t threads) {
+    // Below this many players per thread, spawning threads costs more than it saves
+    const size_t MIN_CHUNK = 1 << 15;
+
+    const size_t n = players.size();
+    const size_t top_count = std::floor(std::clamp(fraction, 0.0, 1.0) * n);
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, n / MIN_CHUNK);
+    if (threads <= 1 || top_count == 0) {
+        return quickSelectRank(players, fraction);
+    }
+
+    PhaseTimer timer;
+
+    auto chunkBegin = [&](size_t t) { return t * n / threads; };
+
+    // 1) Bracket the cutoff between two pivots taken from a sorted random sample
+    const size_t sample_size = std::min<size_t>(n, 4096);
+    std::vector<size_t> sample(sample_size);
+    std::mt19937_64 rng(n);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    for (auto& level : sample) {
+        level = players[pick(rng)].level_;
+    }
+    std::sort(sample.begin(), sample.end(), std::greater<size_t>());
+    const size_t rank = top_count * sample_size / n;
+    const size_t slack = 4 * static_cast<size_t>(std::sqrt(sample_size));
+    size_t hi = sample[rank > slack ? rank - slack : 0];
+    size_t lo = sample[std::min(sample_size - 1, rank + slack)];
+    if (rank <= slack) {
+        hi = SIZE_MAX;
+    }
+    if (rank + slack >= sample_size) {
+        lo = 0;
+    }
+
+    // 2) Count players above the bracket & collect the levels inside it, per chunk
+    size_t cutoff = 0;
+    std::vector<size_t> above(threads);
+    std::vector<std::vector<size_t>> inside(threads);
+    for (int attempt = 0; attempt < 2; attempt++) {
+        parallelFor(threads, [&](size_t t) {
+            above[t] = 0;
+            inside[t].clear();
+            for (size_t i = chunkBegin(t); i < chunkBegin(t + 1); i++) {
+                const size_t level = players[i].level_;
+                if (level > hi) {
+                    above[t]++;
+                } else if (level >= lo) {
+                    inside[t].push_back(level);
+                }
+            }
+        });
+
+        size_t total_above = 0;
+        std::vector<size_t> middle;
+        for (size_t t = 0; t < threads; t++) {
+            total_above += above[t];
+            middle.insert(middle.end(), inside[t].begin(), inside[t].end());
+        }
+
+        if (total_above < top_count && top_count <= total_above + middle.size()) {
+            auto nth = middle.begin() + (top_count - total_above - 1);
+            std::nth_element(middle.begin(), nth, middle.end(), std::greater<size_t>());
+            cutoff = *nth;
+            break;
+        }
+        // The sample missed the cutoff; retry with a bracket covering every level
+        hi = SIZE_MAX;
+        lo = 0;
+    }
+
+    // 3) Count winners per chunk, then hand out the tied players at the cutoff in chunk order
+    std::vector<size_t> greater(threads), equal(threads);
+    parallelFor(threads, [&](size_t t) {
+        greater[t] = equal[t] = 0;
+        for (size_t i = chunkBegin(t); i < chunkBegin(t + 1); i++) {
+            greater[t] += players[i].level_ > cutoff;
+            equal[t] += players[i].level_ == cutoff;
+        }
+    });
+    size_t ties_left = top_count;
+    for (size_t t = 0; t < threads; t++) {
+        ties_left -= greater[t];
+    }
+    std::vector<size_t> ties(threads), offset(threads + 1, 0);
+    for (size_t t = 0; t < threads; t++) {
+        ties[t] = std::min(equal[t], ties_left);
+        ties_left -= ties[t];
+        offset[t + 1] = offset[t] + greater[t] + ties[t];
+    }
+    timer.lap(&RankingPhases::select_);
+
+    // Move each chunk's winners into its own slice of the result & sort the slice
+    std::vector<Player> top(top_count);
+    parallelFor(threads, [&](size_t t) {
+        size_t out = offset[t];
+        size_t ties_taken = 0;
+        for (size_t i = chunkBegin(t); i < chunkBegin(t + 1); i++) {
+            const size_t level = players[i].level_;
+            if (level > cutoff || (level == cutoff && ties_taken++ < ties[t])) {
+                top[out++] = std::move(players[i]);
+            }
+        }
+        std::sort(top.begin() + offset[t], top.begin() + offset[t + 1]);
+    });
+    timer.lap(&RankingPhases::copy_); // Includes sorting the slices, done in the same parallel pass
+
+    // 4) Merge neighbouring sorted slices pairwise until one remains
+    for (size_t width = 1; width < threads; width *= 2) {
+        size_t merges = (threads + 2 * width - 1) / (2 * width);
+        parallelFor(merges, [&](size_t m) {
+            size_t first = 2 * m * width;
+            size_t middle = std::min(threads, first + width);
+            size_t last = std::min(threads, first + 2 * width);
+            std::inplace_merge(top.begin() + offset[first], top.begin() + offset[middle], top.begin() + offset[last]);
+        });
+    }
+
+    return timer.result(&RankingPhases::sort_, std::move(top));
+}
+
+RankingResult externalRank(const std::string& path, double fraction, size_t chunk_size) {
+    PhaseTimer timer;
+
+    timer.pause(&RankingPhases::select_);
+    PlayerFile::Reader reader(path);
+    timer.resume();
+    size_t top_count = std::floor(std::clamp(fraction, 0.0, 1.0) * reader.count());
+    std::vector<Player> top;
+
+    if (top_count > 0) {
+        chunk_size = std::max<size_t>(chunk_size, 1);
+        // buffer[0, top_count) is the running top once full; the room behind it holds survivors
+        std::vector<Player> buffer(top_count + std::max(top_count, chunk_size));
+        size_t depth_limit = 2 * floorLog2(buffer.size());
+        size_t size = 0;
+        bool full = false;
+        size_t minimum = 0;
+
+        for (;;) {
+            timer.pause(&RankingPhases::select_);
+            size_t read = reader.read(buffer.data() + size, std::min(chunk_size, buffer.size() - size));
+            timer.resume();
+            if (read == 0) break;
+
+            if (!full) {
+                size += read;
             } else {
-                right = pivot_idx - 1;
+                // Players at or below the running top's minimum can't raise any level in it
+                for (size_t i = size, end = size + read; i < end; i++) {
+                    if (buffer[i].level_ > minimum) {
+                        std::swap(buffer[size++], buffer[i]);
+                    }
+                }
+            }
+
+            if (size == buffer.size()) {
+                select(buffer, 0, size - 1, top_count - 1, depth_limit);
+                size = top_count;
+                full = true;
+                minimum = buffer[top_count - 1].level_;
             }
         }
-        
-        // Extract and sort the top elements
-        top.assign(players.begin(), players.begin() + top_count);
-        std::sort(top.begin(), top.end());
+
+        if (size > top_count) {
+            select(buffer, 0, size - 1, top_count - 1, depth_limit);
+        }
+        size = std::min(size, top_count);
+        timer.lap(&RankingPhases::select_);
+        if (size > 0) {
+            quickSort(buffer, 0, size - 1, depth_limit);
+        }
+        timer.lap(&RankingPhases::sort_);
+        buffer.resize(size);
+        top = std::move(buffer);
     }
 
-    auto end = high_resolution_clock::now();
-    return RankingResult(top, {}, duration_cast<milliseconds>(end - start).count());
+    return timer.result(&RankingPhases::copy_, std::move(top));
 }
 
 } // namespace Offline
@@ -135,40 +820,637 @@ void replaceMin(PlayerIt first, PlayerIt last, Player& target) {
     }
 }
 
-RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval) {
-    auto start = high_resolution_clock::now();
+KllSketch::KllSketch(double epsilon, std::mt19937_64::result_type seed)
+    : k_(std::max<size_t>(8, std::ceil(3 / epsilon))), count_(0), retained_(0), capacity_(0),
+      compactors_(1), capacities_(1), coin_(seed) {
+    capacities_[0] = capacity_ = capacity(0);
+}
+
+size_t KllSketch::capacity(size_t h) const {
+    size_t depth = compactors_.size() - 1 - h;
+    return std::max<size_t>(2, std::ceil(k_ * std::pow(2.0 / 3.0, depth)));
+}
+
+void KllSketch::insert(size_t level) {
+    compactors_[0].push_back(level);
+    count_++;
+    if (++retained_ > capacity_) {
+        compress();
+    }
+}
+
+void KllSketch::compress() {
+    for (size_t h = 0; h < compactors_.size(); h++) {
+        if (compactors_[h].size() < capacities_[h]) continue;
+
+        // A new top compactor shrinks every capacity below it
+        if (h + 1 == compactors_.size()) {
+            compactors_.emplace_back();
+            capacities_.resize(compactors_.size());
+            capacity_ = 0;
+            for (size_t level = 0; level < compactors_.size(); level++) {
+                capacities_[level] = capacity(level);
+                capacity_ += capacities_[level];
+            }
+        }
+        std::vector<size_t>& compactor = compactors_[h];
+        std::vector<size_t>& above = compactors_[h + 1];
+        std::sort(compactor.begin(), compactor.end());
+
+        // An odd level out stays behind; the rest are paired up & one of each pair promoted
+        size_t kept = compactor.size() % 2;
+        size_t offset = coin_() & 1;
+        for (size_t i = kept + offset; i < compactor.size(); i += 2) {
+            above.push_back(compactor[i]);
+        }
+        retained_ -= (compactor.size() - kept) / 2;
+        compactor.resize(kept);
+        break;
+    }
+
+}
+
+size_t KllSketch::count() const {
+    return count_;
+}
+
+size_t KllSketch::retained() const {
+    return retained_;
+}
+
+size_t KllSketch::quantile(size_t rank) const {
+    // Each held level stands for 2^h inserted ones
+    std::vector<std::pair<size_t, size_t>> weighted;
+    weighted.reserve(retained_);
+    for (size_t h = 0; h < compactors_.size(); h++) {
+        for (size_t level : compactors_[h]) {
+            weighted.emplace_back(level, size_t(1) << h);
+        }
+    }
+    std::sort(weighted.begin(), weighted.end());
+
+    size_t below = 0;
+    for (const auto& [level, weight] : weighted) {
+        below += weight;
+        if (below > rank) return level;
+    }
+    return weighted.back().first;
+}
+
+/**
+ * @brief rankIncoming()'s approximate mode: tracks every level in a KllSketch
+ * instead of keeping the top players.
+*/
+RankingResult rankIncomingApprox(PlayerStream& stream, const size_t& reporting_interval, double epsilon) {
+    PhaseTimer timer;
+    KllSketch sketch(epsilon);
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t next_report = reporting_interval;
+
+    // The lowest level in the top r of n has ascending rank n - r (or 0, until n >= r)
+    auto cutoff = [&]() {
+        size_t count = sketch.count();
+        return sketch.quantile(count > reporting_interval ? count - reporting_interval : 0);
+    };
+
+    std::vector<Player> batch(STREAM_BATCH_SIZE);
+    for (;;) {
+        timer.pause(&RankingPhases::select_);
+        size_t pulled = stream.nextBatch(batch.data(), batch.size());
+        timer.resume();
+        if (pulled == 0) break;
+
+        for (size_t i = 0; i < pulled; i++) {
+            sketch.insert(batch[i].level_);
+            if (sketch.count() == next_report) {
+                cutoffs[sketch.count()] = cutoff();
+                next_report += reporting_interval;
+            }
+        }
+    }
+    if (sketch.count() > 0) {
+        cutoffs[sketch.count()] = cutoff();
+    }
+
+    return timer.result(&RankingPhases::select_, {}, std::move(cutoffs));
+}
+
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, double epsilon) {
+    if (epsilon > 0) {
+        return rankIncomingApprox(stream, reporting_interval, epsilon);
+    }
+    PhaseTimer timer;
     std::vector<Player> top_players;
     std::unordered_map<size_t, size_t> cutoffs;
     size_t count = 0;
-    
-    //Process players from the stream
-    while (stream.remaining() > 0) {
-        Player player = stream.nextPlayer();
-        count++;
-        //Maintain top players in a min-heap
-        if (top_players.size() < reporting_interval) {
-            top_players.push_back(std::move(player));
-            if (top_players.size() == reporting_interval) {
-                std::make_heap(top_players.begin(), top_players.end(), std::greater<Player>());
-            }
-        } 
-        else if (player > top_players.front()) {
-            replaceMin(top_players.begin(), top_players.end(), player);
-        }
-        
-        // Record cutoff at intervals and at the end
-        if (count % reporting_interval == 0 || stream.remaining() == 0) {
-            if (!top_players.empty()) {
+    size_t next_report = reporting_interval;
+
+    // Pull players a block at a time, then work through the block without further virtual calls
+    std::vector<Player> batch(STREAM_BATCH_SIZE);
+    for (;;) {
+        timer.pause(&RankingPhases::select_);
+        size_t pulled = stream.nextBatch(batch.data(), batch.size());
+        timer.resume();
+        if (pulled == 0) break;
+
+        for (size_t i = 0; i < pulled; i++) {
+            Player& player = batch[i];
+            count++;
+            //Maintain top players in a min-heap
+            if (top_players.size() < reporting_interval) {
+                top_players.push_back(std::move(player));
+                if (top_players.size() == reporting_interval) {
+                    std::make_heap(top_players.begin(), top_players.end(), std::greater<Player>());
+                }
+            }
+            else if (player > top_players.front()) {
+                replaceMin(top_players.begin(), top_players.end(), player);
+            }
+
+            // Record cutoff at intervals
+            if (count == next_report) {
                 cutoffs[count] = top_players.front().level_;
+                next_report += reporting_interval;
             }
         }
     }
+
+    // ...and at the end
+    if (!top_players.empty()) {
+        cutoffs[count] = top_players.front().level_;
+    }
+    timer.lap(&RankingPhases::select_);
     
     // Sort the top players in ascending order
     std::sort(top_players.begin(), top_players.end());
     
-    auto end = high_resolution_clock::now();
-    return RankingResult(top_players, cutoffs, duration_cast<milliseconds>(end - start).count());
+    return timer.result(&RankingPhases::sort_, std::move(top_players), std::move(cutoffs));
+}
+
+WindowRanker::WindowRanker(size_t top_count)
+    : top_count_(std::max<size_t>(top_count, 1)), first_sequence_(0) {}
+
+void WindowRanker::push(Player&& player, Clock::time_point arrival) {
+    Key key{player.level_, first_sequence_ + window_.size()};
+    window_.push_back({std::move(player), arrival});
+
+    // Keys below the max of rest_ go straight back out as top_'s new minimum
+    top_.insert(key);
+    if (top_.size() > top_count_) {
+        rest_.insert(rest_.end(), top_.extract(top_.begin())); // Relinks the node, no reallocation
+    }
+}
+
+void WindowRanker::expireOldest() {
+    if (window_.empty()) return;
+
+    Key key{window_.front().player_.level_, first_sequence_};
+    if (top_.erase(key)) {
+        if (!rest_.empty()) {
+            top_.insert(top_.begin(), rest_.extract(std::prev(rest_.end())));
+        }
+    } else {
+        rest_.erase(key);
+    }
+
+    window_.pop_front();
+    first_sequence_++;
+}
+
+void WindowRanker::expireBefore(Clock::time_point cutoff) {
+    while (!window_.empty() && window_.front().time_ < cutoff) {
+        expireOldest();
+    }
+}
+
+size_t WindowRanker::size() const {
+    return window_.size();
+}
+
+size_t WindowRanker::cutoff() const {
+    return top_.begin()->level_;
+}
+
+std::vector<Player> WindowRanker::top() const {
+    std::vector<Player> top;
+    top.reserve(top_.size());
+    for (const Key& key : top_) {
+        top.push_back(window_[key.sequence_ - first_sequence_].player_);
+    }
+    return top;
+}
+
+/**
+ * @brief Shared body of rankWindow() and rankRecent(): feeds the stream through a
+ * WindowRanker, calling expire(ranker, now) after each arrival to age players out.
+ * `now` is the time the arrival's batch was fetched, read once per batch.
+*/
+template <class Expire>
+RankingResult rankSliding(PlayerStream& stream, const size_t& reporting_interval, Expire expire) {
+    PhaseTimer timer;
+    WindowRanker ranker(reporting_interval);
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t count = 0;
+    size_t next_report = reporting_interval;
+
+    std::vector<Player> batch(STREAM_BATCH_SIZE);
+    for (;;) {
+        timer.pause(&RankingPhases::select_);
+        size_t pulled = stream.nextBatch(batch.data(), batch.size());
+        WindowRanker::Clock::time_point now = WindowRanker::Clock::now();
+        timer.resume();
+        if (pulled == 0) break;
+
+        for (size_t i = 0; i < pulled; i++) {
+            count++;
+            ranker.push(std::move(batch[i]), now);
+            expire(ranker, now);
+
+            if (count == next_report) {
+                cutoffs[count] = ranker.cutoff();
+                next_report += reporting_interval;
+            }
+        }
+    }
+    if (ranker.size() > 0) {
+        cutoffs[count] = ranker.cutoff();
+    }
+    timer.lap(&RankingPhases::select_);
+
+    // The ranker keeps its top players in order, so they only need copying out
+    std::vector<Player> top = ranker.top();
+    return timer.result(&RankingPhases::copy_, std::move(top), std::move(cutoffs));
+}
+
+RankingResult rankWindow(PlayerStream& stream, const size_t& reporting_interval, const size_t& window_size) {
+    size_t window = std::max<size_t>(window_size, 1);
+    return rankSliding(stream, reporting_interval, [window](WindowRanker& ranker, WindowRanker::Clock::time_point) {
+        if (ranker.size() > window) ranker.expireOldest();
+    });
+}
+
+RankingResult rankRecent(PlayerStream& stream, const size_t& reporting_interval, WindowRanker::Clock::duration window) {
+    return rankSliding(stream, reporting_interval, [window](WindowRanker& ranker, WindowRanker::Clock::time_point now) {
+        ranker.expireBefore(now - window);
+    });
+}
+
+LiveLeaderboard::LiveLeaderboard(size_t top_count)
+    : top_count_(std::max<size_t>(top_count, 1)), settled_(true) {}
+
+bool LiveLeaderboard::above(bool in_top, const Player& a, const Player& b) const {
+    return in_top ? a.level_ < b.level_ : a.level_ > b.level_;
+}
+
+size_t LiveLeaderboard::siftUp(bool in_top, size_t index) {
+    std::vector<Player>& heap = in_top ? top_ : rest_;
+    Player moving = std::move(heap[index]);
+
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!above(in_top, moving, heap[parent])) break;
+        heap[index] = std::move(heap[parent]);
+        if (settled_) slots_[heap[index].id_].index_ = index;
+        index = parent;
+    }
+    heap[index] = std::move(moving);
+    if (settled_) slots_[heap[index].id_] = {in_top, index};
+    return index;
+}
+
+size_t LiveLeaderboard::siftDown(bool in_top, size_t index) {
+    std::vector<Player>& heap = in_top ? top_ : rest_;
+    Player moving = std::move(heap[index]);
+
+    while (true) {
+        size_t child = 2 * index + 1;
+        if (child >= heap.size()) break;
+        if (child + 1 < heap.size() && above(in_top, heap[child + 1], heap[child])) child++;
+        if (!above(in_top, heap[child], moving)) break;
+        heap[index] = std::move(heap[child]);
+        if (settled_) slots_[heap[index].id_].index_ = index;
+        index = child;
+    }
+    heap[index] = std::move(moving);
+    if (settled_) slots_[heap[index].id_] = {in_top, index};
+    return index;
+}
+
+void LiveLeaderboard::push(bool in_top, Player&& player) {
+    std::vector<Player>& heap = in_top ? top_ : rest_;
+    heap.push_back(std::move(player));
+    siftUp(in_top, heap.size() - 1);
+}
+
+Player LiveLeaderboard::popRoot(bool in_top) {
+    std::vector<Player>& heap = in_top ? top_ : rest_;
+    Player root = std::move(heap.front());
+    if (heap.size() > 1) {
+        heap.front() = std::move(heap.back());
+        heap.pop_back();
+        siftDown(in_top, 0);
+    } else {
+        heap.pop_back();
+    }
+    return root;
 }
 
-} // namespace Online
\ No newline at end of file
+void LiveLeaderboard::rebalance() {
+    if (top_.size() < top_count_ && !rest_.empty()) {
+        push(true, popRoot(false));
+    } else if (top_.size() > top_count_) {
+        push(false, popRoot(true));
+    }
+    // A single change can leave at most one player on the wrong side
+    if (!top_.empty() && !rest_.empty() && rest_.front().level_ > top_.front().level_) {
+        Player promoted = popRoot(false);
+        Player demoted = popRoot(true);
+        push(true, std::move(promoted));
+        push(false, std::move(demoted));
+    }
+}
+
+void LiveLeaderboard::assign(std::vector<Player>&& players, size_t top_count) {
+    top_count_ = std::max<size_t>(top_count, 1);
+    slots_.clear();
+    repartition(std::move(players));
+}
+
+void LiveLeaderboard::updateAll(std::vector<Player>&& players) {
+    if (settled_) {
+        for (Player& player : players) {
+            auto slot = slots_.find(player.id_);
+            if (slot == slots_.end()) {
+                slots_.emplace(player.id_, Slot{false, rest_.size()});
+                rest_.push_back(std::move(player));
+            } else {
+                std::vector<Player>& heap = slot->second.in_top_ ? top_ : rest_;
+                heap[slot->second.index_] = std::move(player);
+            }
+        }
+    } else {
+        // Rather than settle() the index, find the previous states in one pass over both heaps
+        std::unordered_map<size_t, size_t> latest; // Id -> index of its last state in `players`
+        latest.reserve(players.size());
+        for (size_t i = 0; i < players.size(); i++) {
+            latest[players[i].id_] = i;
+        }
+        for (std::vector<Player>* heap : {&top_, &rest_}) {
+            for (Player& player : *heap) {
+                if (latest.empty()) break;
+                auto change = latest.find(player.id_);
+                if (change != latest.end()) {
+                    player = std::move(players[change->second]);
+                    latest.erase(change);
+                }
+            }
+        }
+        // Whoever is left is new
+        for (const auto& [id, index] : latest) {
+            rest_.push_back(std::move(players[index]));
+        }
+    }
+
+    // Re-partition rest_'s buffer, with the (fewer) top players appended
+    std::vector<Player> all = std::move(rest_);
+    std::move(top_.begin(), top_.end(), std::back_inserter(all));
+    repartition(std::move(all));
+}
+
+void LiveLeaderboard::repartition(std::vector<Player>&& players) {
+    // Select the top players at the back, so only they move out & the rest stays in place
+    size_t split = players.size() - std::min(top_count_, players.size());
+    std::nth_element(players.begin(), players.begin() + split, players.end(), std::less<Player>());
+
+    top_.assign(std::make_move_iterator(players.begin() + split), std::make_move_iterator(players.end()));
+    std::make_heap(top_.begin(), top_.end(), std::greater<Player>());
+    players.resize(split);
+    rest_ = std::move(players);
+
+    // Every player has moved, so leave rest_'s heap & the index to settle() if they're ever needed
+    settled_ = false;
+}
+
+void LiveLeaderboard::settle() {
+    std::make_heap(rest_.begin(), rest_.end(), std::less<Player>());
+
+    // Ids are never removed, so the map keeps its nodes instead of reallocating them
+    slots_.reserve(size());
+    for (size_t i = 0; i < top_.size(); i++) slots_[top_[i].id_] = {true, i};
+    for (size_t i = 0; i < rest_.size(); i++) slots_[rest_[i].id_] = {false, i};
+    settled_ = true;
+}
+
+void LiveLeaderboard::setTopCount(size_t top_count) {
+    top_count_ = std::max<size_t>(top_count, 1);
+    if (!settled_) {
+        // rest_ is unordered: demote without sifting it, and promote by one selection
+        while (top_.size() > top_count_) {
+            rest_.push_back(popRoot(true));
+        }
+        if (top_.size() < top_count_ && !rest_.empty()) {
+            size_t split = rest_.size() - std::min(top_count_ - top_.size(), rest_.size());
+            std::nth_element(rest_.begin(), rest_.begin() + split, rest_.end(), std::less<Player>());
+            std::move(rest_.begin() + split, rest_.end(), std::back_inserter(top_));
+            rest_.resize(split);
+            std::make_heap(top_.begin(), top_.end(), std::greater<Player>());
+        }
+        return;
+    }
+    while (top_.size() > top_count_) {
+        push(false, popRoot(true));
+    }
+    while (top_.size() < top_count_ && !rest_.empty()) {
+        push(true, popRoot(false));
+    }
+}
+
+void LiveLeaderboard::update(Player&& player) {
+    if (!settled_) settle();
+    auto slot = slots_.find(player.id_);
+    if (slot == slots_.end()) {
+        push(true, std::move(player));
+    } else {
+        // Replace the previous state in place, then sift whichever way the level moved
+        bool in_top = slot->second.in_top_;
+        size_t index = slot->second.index_;
+        (in_top ? top_ : rest_)[index] = std::move(player);
+        siftDown(in_top, siftUp(in_top, index));
+    }
+    rebalance();
+}
+
+size_t LiveLeaderboard::size() const {
+    return top_.size() + rest_.size();
+}
+
+size_t LiveLeaderboard::cutoff() const {
+    return top_.front().level_;
+}
+
+std::vector<Player> LiveLeaderboard::top() const {
+    std::vector<Player> top(top_);
+    std::sort(top.begin(), top.end());
+    return top;
+}
+
+RankingResult rankLive(PlayerStream& stream, const size_t& reporting_interval) {
+    PhaseTimer timer;
+    LiveLeaderboard leaderboard(reporting_interval);
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t count = 0;
+    size_t next_report = reporting_interval;
+
+    std::vector<Player> batch(STREAM_BATCH_SIZE);
+    for (;;) {
+        timer.pause(&RankingPhases::select_);
+        size_t pulled = stream.nextBatch(batch.data(), batch.size());
+        timer.resume();
+        if (pulled == 0) break;
+
+        for (size_t i = 0; i < pulled; i++) {
+            count++;
+            leaderboard.update(std::move(batch[i]));
+
+            if (count == next_report) {
+                cutoffs[count] = leaderboard.cutoff();
+                next_report += reporting_interval;
+            }
+        }
+    }
+    if (leaderboard.size() > 0) {
+        cutoffs[count] = leaderboard.cutoff();
+    }
+    timer.lap(&RankingPhases::select_);
+
+    std::vector<Player> top = leaderboard.top(); // Copies & sorts the top heap
+    return timer.result(&RankingPhases::sort_, std::move(top), std::move(cutoffs));
+}
+
+RankingResult rankConcurrent(const std::vector<PlayerStream*>& streams, const size_t& reporting_interval) {
+    PhaseTimer timer;
+    const size_t top_count = std::max<size_t>(reporting_interval, 1);
+    const size_t producers = streams.size();
+
+    // Shared state, guarded by `mutex` & merged into one batch at a time, as rankIncoming() would read them
+    std::mutex mutex;
+    std::vector<Player> top_players;
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t count = 0;
+    size_t next_report = top_count;
+
+    // Once top_players is full, its minimum + 1: the lowest level that can still enter.
+    // Read without the lock, so a producer may filter by a stale (lower) floor, never a higher one.
+    std::atomic<size_t> admit_from{0};
+
+    parallelFor(producers, [&](size_t p) {
+        PlayerStream& stream = *streams[p];
+        std::vector<Player> batch(STREAM_BATCH_SIZE);
+        std::vector<size_t> positions(STREAM_BATCH_SIZE); // Each candidate's index in the batch
+
+        for (;;) {
+            size_t pulled = stream.nextBatch(batch.data(), batch.size());
+            if (pulled == 0) break;
+
+            // Drop everything below the floor before taking the lock, keeping candidates in order
+            size_t floor = admit_from.load(std::memory_order_relaxed);
+            size_t candidates = 0;
+            for (size_t i = 0; i < pulled; i++) {
+                if (batch[i].level_ >= floor) {
+                    if (candidates != i) batch[candidates] = std::move(batch[i]);
+                    positions[candidates++] = i;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            const size_t first = count;
+
+            // Records the cutoff at every milestone up to `read` players; the dropped players in between changed nothing
+            auto reportUpTo = [&](size_t read) {
+                while (next_report <= read) {
+                    cutoffs[next_report] = top_players.front().level_;
+                    next_report += top_count;
+                }
+            };
+
+            for (size_t c = 0; c < candidates; c++) {
+                reportUpTo(first + positions[c]);
+                Player& player = batch[c];
+
+                //Maintain the global top players in a min-heap
+                if (top_players.size() < top_count) {
+                    top_players.push_back(std::move(player));
+                    if (top_players.size() == top_count) {
+                        std::make_heap(top_players.begin(), top_players.end(), std::greater<Player>());
+                    }
+                } else if (player > top_players.front()) {
+                    replaceMin(top_players.begin(), top_players.end(), player);
+                }
+            }
+            count = first + pulled;
+            reportUpTo(count);
+
+            if (top_players.size() == top_count) {
+                admit_from.store(top_players.front().level_ + 1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    // ...and at the end
+    if (!top_players.empty()) {
+        cutoffs[count] = top_players.front().level_;
+    }
+    timer.lap(&RankingPhases::select_); // Includes the producers' fetches, which overlap the others' ranking
+
+    std::sort(top_players.begin(), top_players.end());
+    return timer.result(&RankingPhases::sort_, std::move(top_players), std::move(cutoffs));
+}
+
+} // namespace Online
+
+namespace Offline {
+
+IncrementalRanker::IncrementalRanker(std::vector<Player> players, double fraction)
+    : fraction_(std::clamp(fraction, 0.0, 1.0)), leaderboard_(1), rebuilds_(0) {
+    size_t top_count = topCount(players.size());
+    leaderboard_.assign(std::move(players), top_count);
+}
+
+size_t IncrementalRanker::topCount(size_t n) const {
+    return std::floor(fraction_ * n);
+}
+
+void IncrementalRanker::apply(std::vector<Player>&& changed) {
+    size_t n = leaderboard_.size();
+
+    // Past D log N > N, sifting each change costs more than re-partitioning once
+    if (n > 0 && changed.size() * floorLog2(n) > n) {
+        leaderboard_.updateAll(std::move(changed));
+        rebuilds_++;
+    } else {
+        for (Player& player : changed) {
+            leaderboard_.update(std::move(player));
+        }
+    }
+    // New players may have grown the table, and with it the top fraction
+    leaderboard_.setTopCount(topCount(leaderboard_.size()));
+}
+
+RankingResult IncrementalRanker::result() const {
+    PhaseTimer timer;
+    std::vector<Player> top;
+    if (topCount(leaderboard_.size()) > 0) {
+        top = leaderboard_.top(); // Copies & sorts the top heap
+    }
+    return timer.result(&RankingPhases::sort_, std::move(top));
+}
+
+size_t IncrementalRanker::cutoff() const {
+    return leaderboard_.cutoff();
+}
+
+size_t IncrementalRanker::rebuilds() const {
+    return rebuilds_;
+}
+
+} // namespace Offline
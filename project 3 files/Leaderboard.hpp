@@ -3,12 +3,27 @@
 #include "Player.hpp"
 #include "PlayerStream.hpp"
 
+#include <deque>
 #include <iterator>
+#include <random>
+#include <set>
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief A ranking's time broken down by phase, in ms. Phases a ranker doesn't have stay 0.
+ */
+struct RankingPhases {
+    double select_ = 0; // Finding the top players: partitioning, heaping, counting or streaming through them
+    double sort_ = 0;   // Putting the top players in order
+    double copy_ = 0;   // Copying or moving the top players into the result
+    double fetch_ = 0;  // Waiting on a stream or file for players, which elapsed_ excludes
+};
 
 struct RankingResult {
     /**
@@ -44,6 +59,21 @@ struct RankingResult {
      */
     double elapsed_;
 
+    /**
+     * @brief Where the time went: elapsed_ is select_ + sort_ + copy_, timed on steady_clock
+     * to the nanosecond. fetch_ is timed too, but is not part of elapsed_.
+     */
+    RankingPhases phases_;
+
+    /**
+     * @brief Hardware event counts over the ranking on the calling thread, excluding fetches,
+     * keyed by perf event name: "cycles", "instructions", "cache-misses" & "branch-misses".
+     *
+     * Only filled in builds with PERF_COUNTERS defined (see the Makefile / CMakeLists.txt),
+     * and only with the events perf_event_open() allows. Otherwise it's empty.
+     */
+    std::unordered_map<std::string, uint64_t> counters_;
+
     /**
      * @brief Constructor for RankingResult with top players, cutoffs, and elapsed time.
      *
@@ -55,43 +85,228 @@ struct RankingResult {
      * @param elapsed Time taken to calculate the ranking, in ms.
      */
     RankingResult(const std::vector<Player>& top = {}, const std::unordered_map<size_t, size_t>& cutoffs = {}, double elapsed = 0);
+
+    /**
+     * @brief Constructor for RankingResult that takes over the top players and cutoffs
+     * instead of copying them. Every ranker builds its result through this overload.
+     *
+     * @param top An r-value ref. to the vector of top-ranked Player objects, in sorted order.
+     * @param cutoffs An r-value ref. to the map of player count thresholds to minimum level cutoffs.
+     * @param elapsed Time taken to calculate the ranking, in ms.
+     * @post `top` and `cutoffs` are left valid but unspecified (in practice, empty).
+     */
+    RankingResult(std::vector<Player>&& top, std::unordered_map<size_t, size_t>&& cutoffs = {}, double elapsed = 0);
 };
 
 namespace Offline {
+using PlayerIt = std::vector<Player>::iterator;
+
 /**
  * @brief Uses a mixture of quickselect/quicksort to
- *        select and sort the top 10% of players with O(log N) memory
+ *        select and sort the top fraction of players with O(log N) memory
  *        (excluding the returned RankingResult vector)
  *
+ * Selection is an introselect: three-way (Dutch-flag) partitioning around ninther or
+ * median-of-3 pivots, switching to median-of-medians pivots after 2 log N rounds, so
+ * sorted input and heavily repeated levels stay O(N). Only the selected prefix is then
+ * quicksorted (with the same pivots, three-way partitioning & a heapsort fallback).
+ *
  * @param players A reference to the vector of Player objects to be ranked
+ * @param fraction The fraction of players to select, in [0, 1]. Defaults to 10%.
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top fraction of players from the input in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The order of the parameter vector is modified, and the selected players are moved out of it.
+ */
+RankingResult quickSelectRank(std::vector<Player>& players, double fraction = 0.1);
+
+/**
+ * @brief Selects and sorts the top fraction of players like quickSelectRank(), but over
+ *        a packed array of 16-byte (level, index) keys instead of the Players themselves
+ *
+ * Partitioning and sorting only move & compare keys, which never touch a player's name,
+ * so far less memory is moved per swap and scanned per comparison. Players are copied
+ * from the input only for the k winners, once their order is known.
+ * Uses O(N) extra memory for the keys.
+ *
+ * @param players A const reference to the vector of Player objects to be ranked
+ * @param fraction The fraction of players to select, in [0, 1]. Defaults to 10%.
  * @return A Ranking Result object whose
- * - top_ vector -> Contains the top 10% of players from the input in sorted order (ascending)
+ * - top_ vector -> Contains the top fraction of players from the input in sorted order (ascending)
  * - cutoffs_    -> Is empty
  * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ */
+RankingResult keyRank(const std::vector<Player>& players, double fraction = 0.1);
+
+/**
+ * @brief Rearranges [first, last) into a d-ary min-heap ordered by level.
+ *
+ * Node i's children are at indices arity * i + 1, ..., arity * i + arity.
+ * Performs in O(N) time.
+ *
+ * @param first An iterator to the beginning of the range
+ * @param last An iterator to one past the end of the range
+ * @param arity The number of children per node (>= 2)
+ */
+void makeHeap(PlayerIt first, PlayerIt last, const size_t& arity);
+
+/**
+ * @brief Percolates the element at `hole` down a d-ary min-heap until
+ * neither of its children is smaller.
+ *
+ * Performs in O(arity * log_arity N) time, moving (not swapping) elements.
  *
- * @post The order of the parameter vector is modified.
+ * @pre The subtrees below `hole` are d-ary min-heaps.
+ * @param first An iterator to the root of the heap
+ * @param last An iterator to one past the end of the heap
+ * @param hole The index of the element to percolate down
+ * @param arity The number of children per node (>= 2)
  */
-RankingResult quickSelectRank(std::vector<Player>& players);
+void siftDown(PlayerIt first, PlayerIt last, size_t hole, const size_t& arity);
+
+/**
+ * @brief Swaps the minimum (root) of a d-ary min-heap with `target`
+ * and restores the heap property. The d-ary counterpart of Online::replaceMin().
+ *
+ * Performs in O(arity * log_arity N) time.
+ *
+ * @pre The range [first, last) is a d-ary min-heap.
+ * @param first An iterator to the root of the heap
+ * @param last An iterator to one past the end of the heap
+ * @param target A reference to a Player object to be inserted into the heap
+ * @param arity The number of children per node (>= 2)
+ * @post `target` holds the heap's former minimum, so the range it came from
+ *       remains a permutation of the original players.
+ */
+void replaceTop(PlayerIt first, PlayerIt last, Player& target, const size_t& arity);
 
 /**
  * @brief Uses an early-stopping version of heapsort to
- *        select and sort the top 10% of players in-place
+ *        select and sort the top fraction of players in-place
  *        (excluding the returned RankingResult vector)
  *
+ * Keeps a d-ary min-heap of the best `k = floor(fraction * N)` players seen so far
+ * in the front of the vector. Each later player that beats the root replaces it in
+ * O(log k), for O(N log k) overall. The heap is then popped in ascending order
+ * into the result.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @param fraction The fraction of players to select, in [0, 1]. Defaults to 10%.
+ * @param arity The number of children per heap node (>= 2). Defaults to 4,
+ *        which halves the heap's depth relative to a binary heap & keeps
+ *        each node's children within one or two cache lines.
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top fraction of players from the input in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The order of the parameter vector is modified, and the selected players are moved out of it.
+ */
+RankingResult heapRank(std::vector<Player>& players, double fraction = 0.1, size_t arity = 4);
+
+/**
+ * @brief The widest level range (max - min) countingRank() histograms directly,
+ * unless the input has even more players than this.
+ */
+const size_t COUNTING_RANGE_LIMIT = 1 << 20;
+
+/**
+ * @brief Uses a level histogram (counting sort) to
+ *        select and sort the top fraction of players in O(N + L) time,
+ *        where L is the range of levels in the input
+ *
+ * 1) One pass finds the level range and a second builds a histogram of levels.
+ * 2) Walking the histogram down from the highest level gives the cutoff level
+ *    and how many players tied at it make the cut.
+ * 3) A final pass moves each winner directly into its sorted position.
+ *
+ * Levels from the sample server fall in [0, 1381), so the histogram is tiny and
+ * no comparisons or swaps are made. If the level range is wider than both
+ * COUNTING_RANGE_LIMIT and the input size, this defers to quickSelectRank().
+ *
  * @param players A reference to the vector of Player objects to be ranked
+ * @param fraction The fraction of players to select, in [0, 1]. Defaults to 10%.
  * @return A Ranking Result object whose
- * - top_ vector -> Contains the top 10% of players from the input in sorted order (ascending)
+ * - top_ vector -> Contains the top fraction of players from the input in sorted order (ascending),
+ *                  with the same levels as quickSelectRank() and heapRank() would return
  * - cutoffs_    -> Is empty
  * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
  *
- * @post The order of the parameter vector is modified.
+ * @post The parameter vector's order is unmodified, but the selected players are moved out of it.
+ *       If the level range is too wide, this defers to quickSelectRank() and its post-conditions apply.
  */
-RankingResult heapRank(std::vector<Player>& players);
+RankingResult countingRank(std::vector<Player>& players, double fraction = 0.1);
+
+/**
+ * @brief Selects and sorts the top fraction of players using multiple threads.
+ *
+ * Splits the input into one contiguous chunk per thread and proceeds in read-only passes:
+ * 1) A sorted sample brackets the cutoff level between two pivots.
+ * 2) Each thread counts its players above the bracket and collects the levels inside it,
+ *    from which the exact cutoff level and the number of tied players to keep are derived.
+ * 3) Each thread moves its chunk's winners into its own slice of the result and sorts it.
+ * 4) The sorted slices are merged pairwise in parallel.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @param fraction The fraction of players to select, in [0, 1]. Defaults to 10%.
+ * @param threads The number of threads to use. 0 (the default) uses std::thread::hardware_concurrency().
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top fraction of players from the input in sorted order (ascending),
+ *                  with the same levels as quickSelectRank() and heapRank() would return
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The parameter vector's order is unmodified, but the selected players are moved out of it.
+ *       If the input is too small to be worth splitting, no players are selected, or one thread
+ *       is requested, this defers to quickSelectRank() and its post-conditions apply.
+ */
+RankingResult parallelRank(std::vector<Player>& players, double fraction = 0.1, size_t threads = 0);
+
+/**
+ * @brief The default number of players externalRank() reads from the file at once.
+ */
+const size_t EXTERNAL_CHUNK_SIZE = 1 << 16;
+
+/**
+ * @brief Selects and sorts the top fraction of players in a player file (see PlayerFile.hpp)
+ *        that may be too large to load into memory, reading it in chunks.
+ *
+ * One buffer holds the top players found so far, followed by room for the players read
+ * since. Chunks are read into that room and, once the running top is full, only players
+ * above its minimum level are kept there. Whenever the room fills, the buffer is reduced
+ * back to its top players by quickselect, and the new minimum is taken.
+ *
+ * The room is at least as large as the top, so each reduction is paid for by as many
+ * surviving players: O(N) expected time overall, plus the file's I/O.
+ *
+ * @param path The path of a binary or CSV player file
+ * @param fraction The fraction of players to select, in [0, 1]. Defaults to 10%.
+ * @param chunk_size The maximum number of players to read at once (> 0)
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top fraction of players in the file in sorted order (ascending),
+ *                  with the same levels as the in-memory rankers would return
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation,
+ *                  excluding reading the file (see phases_.fetch_)
+ *
+ * @note Holds at most floor(fraction * N) + max(floor(fraction * N), chunk_size) Players at once.
+ * @note N must be known upfront, so a CSV file is read twice (its lines are counted first);
+ *       convert it with player_convert to read it once.
+ * @throws std::runtime_error If the file cannot be opened or read, or is malformed.
+ */
+RankingResult externalRank(const std::string& path, double fraction = 0.1, size_t chunk_size = EXTERNAL_CHUNK_SIZE);
 }
 
 namespace Online {
 using PlayerIt = std::vector<Player>::iterator;
 
+/**
+ * @brief The number of Players rankIncoming() requests from its stream at a time.
+ */
+const size_t STREAM_BATCH_SIZE = 4096;
+
 /**
  * @brief A helper method that replaces the minimum element
  * in a min-heap with a target value & preserves the heap
@@ -119,6 +334,69 @@ using PlayerIt = std::vector<Player>::iterator;
  */
 void replaceMin(PlayerIt first, PlayerIt last, Player& target);
 
+/**
+ * @brief A KLL quantile sketch over levels: answers "which level has (approximately)
+ * rank r among the N levels inserted?" to within about epsilon * N ranks, while
+ * keeping only O((1 / epsilon) log(epsilon * N)) levels in memory.
+ *
+ * Levels are kept in a stack of compactors, where a level in compactor h stands for
+ * 2^h inserted levels. Compactor capacities shrink geometrically (by 2/3) going down
+ * from the top. When the sketch holds more than its total capacity, the lowest full
+ * compactor is sorted and every other level (starting at a random one of the first
+ * two) is promoted to the compactor above, halving its contents. That start is a coin
+ * flip from a seeded generator, so a sketch is reproducible for a given seed.
+ *
+ * See Karnin, Lang & Liberty, "Optimal Quantile Approximation in Streams" (2016).
+ */
+class KllSketch {
+public:
+    /**
+     * @brief Constructs an empty sketch.
+     * @param epsilon The target rank error, as a fraction of the levels inserted (> 0).
+     * @param seed Seeds the coin flips that pick which levels each compaction keeps.
+     *      Sketches with the same seed fed the same levels give the same estimates.
+     */
+    KllSketch(double epsilon, std::mt19937_64::result_type seed = std::mt19937_64::default_seed);
+
+    /**
+     * @brief Inserts a level in amortized O(1) time.
+     */
+    void insert(size_t level);
+
+    /**
+     * @brief Retrieves the number of levels inserted.
+     */
+    size_t count() const;
+
+    /**
+     * @brief Retrieves the number of levels the sketch holds in memory.
+     */
+    size_t retained() const;
+
+    /**
+     * @brief Estimates the level with 0-based rank `rank` in ascending order.
+     * @pre At least one level has been inserted.
+     * @param rank The rank to query. Ranks >= count() return the largest level held.
+     * @return A level whose true rank is within about epsilon * count() of `rank`.
+     */
+    size_t quantile(size_t rank) const;
+
+private:
+    size_t k_;                                  // Capacity of the top compactor
+    size_t count_;                              // Levels inserted
+    size_t retained_;                           // Levels held
+    size_t capacity_;                           // Total capacity of every compactor
+    std::vector<std::vector<size_t>> compactors_;
+    std::vector<size_t> capacities_;            // capacity(h) for each compactor
+    std::mt19937_64 coin_;
+
+    // Computes the capacity of compactor h, given the current number of compactors
+    size_t capacity(size_t h) const;
+
+    // Halves the lowest compactor that is at capacity
+    void compress();
+};
+
 /**
  * @brief Exhausts a stream of Players (ie. until there are none left) such that we:
  * 1) Maintain a running collection of the <reporting_interval> highest leveled players
@@ -128,11 +406,22 @@ void replaceMin(PlayerIt first, PlayerIt last, Player& target);
  * @note You should use NOT use a priority-queue.
  *       Instead, use a vector, the STL heap operations, & `replaceMin()`
  *
+ * Players are pulled from the stream STREAM_BATCH_SIZE at a time with
+ * PlayerStream::nextBatch(), so the per-player work is a plain loop over a buffer.
+ *
+ * If `epsilon` > 0, instead runs in approximate mode: rather than keeping the top
+ * <reporting_interval> Players, every level is fed into a KllSketch, and each cutoff is
+ * the level estimated to have <reporting_interval> - 1 levels above it. Memory is then
+ * O((1 / epsilon) log(epsilon * N)) levels no matter how large <reporting_interval> is.
+ * The sketch uses its default seed, so the same stream always gives the same cutoffs.
+ *
  * @param stream A stream providing Player objects
  * @param reporting_interval The frequency at which to record cutoff levels
+ * @param epsilon 0 (the default) for exact ranking. Otherwise, the allowed rank error of
+ *      each cutoff, as a fraction of the players read so far.
  * @return A RankingResult in which:
  * - top_       -> Contains the top <reporting_interval> Players read in the stream in
- *                 sorted (least to greatest) order
+ *                 sorted (least to greatest) order. Empty in approximate mode.
  * - cutoffs_   -> Maps player count milestones to minimum level required at that point
  *                 including the minimum level after ALL players have been read, regardless
  *                 of being a multiple of the reporting interval
@@ -150,5 +439,346 @@ void replaceMin(PlayerIt first, PlayerIt last, Player& target);
  * cutoffs_ = { 50: 239, 100: 992, 132: 994 } (see RankingResult explanation)
  * elapsed_ = 0.003 (Your runtime will vary based on hardware)
  */
-RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval);
-}
\ No newline at end of file
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, double epsilon = 0);
+
+/**
+ * @brief Maintains the top players among a sliding window of the most recent arrivals,
+ * where players age out either by count (only the last W are kept) or by time.
+ *
+ * The window's players are kept in arrival order, and their (level, arrival) keys are split
+ * between two ordered sets: `top_` with the `top_count` highest keys, and `rest_` with the
+ * others. Every key in `top_` is greater than every key in `rest_`, so:
+ * - An arrival is inserted into `top_`, whose minimum is demoted to `rest_` if it overflows.
+ * - An expiry is erased from whichever set holds it; if that was `top_`,
+ *   the maximum of `rest_` is promoted to fill the gap.
+ * Either takes O(log W) time for a window of W players.
+ */
+class WindowRanker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructs an empty WindowRanker.
+     * @param top_count The number of top players to maintain (> 0).
+     */
+    WindowRanker(size_t top_count);
+
+    /**
+     * @brief Adds a player to the window.
+     * @param player An r-value ref. to the Player to move in.
+     * @param arrival The time the player arrived, which must not precede earlier arrivals.
+     *      Only used by expireBefore().
+     */
+    void push(Player&& player, Clock::time_point arrival = Clock::time_point());
+
+    /**
+     * @brief Removes the oldest player from the window, if any.
+     */
+    void expireOldest();
+
+    /**
+     * @brief Removes every player that arrived before `cutoff` from the window.
+     * @param cutoff The earliest arrival time to keep.
+     */
+    void expireBefore(Clock::time_point cutoff);
+
+    /**
+     * @brief Retrieves the number of players in the window.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Retrieves the minimum level to be among the top players right now.
+     * @pre The window is non-empty.
+     * @return The lowest level among the (up to) `top_count` top players in the window.
+     */
+    size_t cutoff() const;
+
+    /**
+     * @brief Copies out the top players of the window.
+     * @return The (up to) `top_count` highest leveled players in the window, in ascending order.
+     */
+    std::vector<Player> top() const;
+
+private:
+    // A player's ordering key: its level, then its arrival sequence number to break ties
+    struct Key {
+        size_t level_;
+        size_t sequence_;
+        bool operator<(const Key& rhs) const {
+            return level_ < rhs.level_ || (level_ == rhs.level_ && sequence_ < rhs.sequence_);
+        }
+    };
+
+    struct Arrival {
+        Player player_;
+        Clock::time_point time_;
+    };
+
+    size_t top_count_;
+    std::set<Key> top_;
+    std::set<Key> rest_;
+
+    // The window's players in arrival order; window_[i] has sequence number first_sequence_ + i
+    std::deque<Arrival> window_;
+    size_t first_sequence_;
+};
+
+/**
+ * @brief Exhausts a stream of Players like rankIncoming(), but ranks only the
+ * `window_size` most recently read players at any point.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The number of top players to maintain, and the frequency at which to record cutoff levels
+ * @param window_size The number of most recent players to rank among (>= reporting_interval for a full leaderboard)
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <reporting_interval> Players among the last <window_size> read,
+ *                 in sorted (least to greatest) order
+ * - cutoffs_   -> Maps player count milestones to the minimum level required within the window
+ *                 at that point, including after ALL players have been read
+ * - elapsed_   -> Contains the duration (ms) of the ranking operation
+ *                 excluding fetching the next player in the stream
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankWindow(PlayerStream& stream, const size_t& reporting_interval, const size_t& window_size);
+
+/**
+ * @brief Exhausts a stream of Players like rankIncoming(), but ranks only the
+ * players that arrived (were read) within the last `window` of time at any point.
+ *
+ * Players are read in batches of STREAM_BATCH_SIZE, and a player's arrival time is when
+ * its batch was fetched, so the players of one batch arrive (and later expire) together.
+ * Expiry is checked as each batch arrives: a player remains eligible up to and including
+ * the last batch fetched no more than `window` after its own. Nothing expires while
+ * waiting on the stream, so a stall does not empty the window.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The number of top players to maintain, and the frequency at which to record cutoff levels
+ * @param window How long a player stays eligible after its batch is fetched
+ * @return A RankingResult like rankWindow()'s, over the players whose batches were fetched
+ *      within `window` of the last batch.
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankRecent(PlayerStream& stream, const size_t& reporting_interval, WindowRanker::Clock::duration window);
+
+/**
+ * @brief Maintains the top players of a live feed in which the same player (by `id_`)
+ * may arrive repeatedly as their level changes.
+ *
+ * Players are split between two binary heaps:
+ * - `top_`, a min-heap of the (up to) `top_count` highest leveled players, and
+ * - `rest_`, a max-heap of every other player seen, so one who falls out of the
+ *   top can climb back in without being re-sent.
+ * A position map from id to heap slot lets an update sift the player in place
+ * (increase-/decrease-key), after which at most one player is exchanged between
+ * the heaps' roots. Each update takes O(log N) time for N distinct players.
+ *
+ * assign() and updateAll() move every player, so they only select the top players, and
+ * leave `rest_` unordered & the position map stale. The next update() rebuilds both in O(N).
+ */
+class LiveLeaderboard {
+public:
+    /**
+     * @brief Constructs an empty LiveLeaderboard.
+     * @param top_count The number of top players to maintain (> 0).
+     */
+    LiveLeaderboard(size_t top_count);
+
+    /**
+     * @brief Replaces the contents with the given players in O(N) time, as if they
+     * were each passed to update() with the given top count, but without sifting.
+     * Leaves `rest_`'s heap & the position map to be rebuilt by the next update().
+     * @pre The players' ids are distinct.
+     * @param players An r-value ref. to the players to move in.
+     * @param top_count The number of top players to maintain (> 0).
+     */
+    void assign(std::vector<Player>&& players, size_t top_count);
+
+    /**
+     * @brief Records a batch of players' latest states like update(), but overwrites them
+     * in place and re-partitions once, in O(N + D) expected time rather than O(D log N).
+     * Leaves `rest_`'s heap & the position map to be rebuilt by the next update(); while
+     * they are stale, the previous states are found by one pass over every player instead.
+     * @param players An r-value ref. to the players to move in.
+     */
+    void updateAll(std::vector<Player>&& players);
+
+    /**
+     * @brief Changes the number of top players maintained, moving players between
+     * the heaps as needed in O(|change| log N) time. After assign() or updateAll(),
+     * promotions instead take one O(N) selection from the unordered `rest_`.
+     * @param top_count The new number of top players to maintain (> 0).
+     */
+    void setTopCount(size_t top_count);
+
+    /**
+     * @brief Records a player's latest state: inserts them if their id is new,
+     * and otherwise replaces their previous state (level & name). Takes O(log N) time,
+     * plus O(N) to rebuild `rest_`'s heap & the position map after assign() or updateAll().
+     * @param player An r-value ref. to the Player to move in.
+     */
+    void update(Player&& player);
+
+    /**
+     * @brief Retrieves the number of distinct players seen.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Retrieves the minimum level to be among the top players right now.
+     * @pre At least one player has been seen.
+     */
+    size_t cutoff() const;
+
+    /**
+     * @brief Copies out the top players.
+     * @return The (up to) `top_count` highest leveled distinct players, in ascending order.
+     */
+    std::vector<Player> top() const;
+
+private:
+    // Where a player's current state lives
+    struct Slot {
+        bool in_top_;
+        size_t index_;
+    };
+
+    size_t top_count_;
+    std::vector<Player> top_;   // Min-heap by level
+    std::vector<Player> rest_;  // Max-heap by level, once settled
+    std::unordered_map<size_t, Slot> slots_;
+    bool settled_;              // Whether rest_ is a heap & slots_ is up to date
+
+    // Whether `a` belongs above `b` in the given heap
+    bool above(bool in_top, const Player& a, const Player& b) const;
+
+    // Moves heap[index] toward the root / leaves until the heap property holds, updating slots_
+    size_t siftUp(bool in_top, size_t index);
+    size_t siftDown(bool in_top, size_t index);
+
+    // Adds a player to a heap, or removes & returns a heap's root
+    void push(bool in_top, Player&& player);
+    Player popRoot(bool in_top);
+
+    // Splits players into top_ (heapified) & rest_ (unordered) by top_count_, unsettling both
+    void repartition(std::vector<Player>&& players);
+
+    // Heapifies rest_ & records every player's slot in slots_
+    void settle();
+
+    // Restores |top_| = min(top_count, N) & top_'s minimum >= rest_'s maximum after one change
+    void rebalance();
+};
+
+/**
+ * @brief Exhausts a live feed of Players like rankIncoming(), but treats elements
+ * sharing an `id_` as updates to the same player rather than new players.
+ *
+ * @param stream A stream providing Player objects, possibly repeating ids
+ * @param reporting_interval The number of top players to maintain, and the frequency (in
+ *      elements read) at which to record cutoff levels
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <reporting_interval> distinct players by their latest level,
+ *                 in sorted (least to greatest) order
+ * - cutoffs_   -> Maps element count milestones to the minimum level required at that point,
+ *                 including after ALL elements have been read
+ * - elapsed_   -> Contains the duration (ms) of the ranking operation
+ *                 excluding fetching the next player in the stream
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankLive(PlayerStream& stream, const size_t& reporting_interval);
+
+/**
+ * @brief Exhausts several streams of Players concurrently, one producer thread per stream,
+ * maintaining the <reporting_interval> highest leveled players across all of them.
+ *
+ * Producers share one top-k min-heap (via `replaceMin()`) behind a mutex, and merge into it
+ * a whole batch at a time, so the result is rankIncoming()'s over the batches in the order
+ * they were merged. Once the heap fills, its minimum is published as a floor, and each
+ * producer drops the players at or below it before taking the lock. Only the survivors are
+ * merged, so the serial part shrinks to O(log k) per player that enters the top; fetching
+ * and filtering run concurrently.
+ *
+ * @param streams Pointers to the streams to read, one producer each
+ * @param reporting_interval The number of top players to maintain, and the frequency (in
+ *      players read from all streams) at which to record cutoff levels
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <reporting_interval> Players read from all streams in
+ *                 sorted (least to greatest) order; the same levels rankIncoming() would
+ *                 return over all of the streams' players
+ * - cutoffs_   -> Maps player count milestones to the minimum level required at that point,
+ *                 including after ALL players have been read; the same counts rankIncoming()
+ *                 would report. Which players precede a milestone depends on the order the
+ *                 producers' batches were merged in.
+ * - elapsed_   -> Contains the duration (ms) of the ranking operation, including fetching,
+ *                 since each producer fetches while the others rank
+ *
+ * @post All elements of every stream are read until there are none remaining.
+ */
+RankingResult rankConcurrent(const std::vector<PlayerStream*>& streams, const size_t& reporting_interval);
+}
+
+namespace Offline {
+/**
+ * @brief Keeps the top fraction of a player table up to date across runs, given only
+ * the players that changed since the last run, instead of re-ranking the whole table.
+ *
+ * Holds the whole table, every player plus a map from id to position, in an
+ * Online::LiveLeaderboard whose top is floor(fraction * N) players: O(N) memory. A delta
+ * of D changed (or new) players is sifted through heaps over all N players, so it costs
+ * O(D log N), not O(D log k). If a delta touches so much of the table that this would
+ * exceed a full O(N) selection (D log N > N), the delta is instead written in place and
+ * the table re-partitioned by one nth_element (a rebuild), as quickSelectRank() would
+ * select it, plus one hash lookup per changed player. Construction and rebuilds leave
+ * the rest of the table unordered & the position map stale: the next sifted delta first
+ * rebuilds both in O(N), while another rebuild finds its players by one scan instead.
+ */
+class IncrementalRanker {
+public:
+    /**
+     * @brief Ranks an initial player table.
+     * @pre The players' ids (`id_`) are distinct.
+     * @param players The initial player table, moved in.
+     * @param fraction The fraction of players to rank, in [0, 1]. Defaults to 10%.
+     */
+    IncrementalRanker(std::vector<Player> players, double fraction = 0.1);
+
+    /**
+     * @brief Applies a delta of changed players to the table.
+     * @param changed The players whose level changed, or who are new, identified by `id_`.
+     * @post The maintained top fraction reflects the table with the delta applied.
+     */
+    void apply(std::vector<Player>&& changed);
+
+    /**
+     * @brief Retrieves the current ranking.
+     * @return A Ranking Result object whose
+     * - top_ vector -> Contains the top fraction of the current table in sorted order (ascending)
+     * - cutoffs_    -> Is empty
+     * - elapsed_    -> Contains the duration (ms) of sorting the maintained top players
+     */
+    RankingResult result() const;
+
+    /**
+     * @brief Retrieves the minimum level in the top fraction of the current table.
+     * @pre The top fraction is non-empty.
+     */
+    size_t cutoff() const;
+
+    /**
+     * @brief Retrieves the number of times a delta was large enough to rebuild the leaderboard.
+     */
+    size_t rebuilds() const;
+
+private:
+    double fraction_;
+    Online::LiveLeaderboard leaderboard_;
+    size_t rebuilds_;
+
+    // floor(fraction_ * n), as the offline rankers compute it
+    size_t topCount(size_t n) const;
+};
+}
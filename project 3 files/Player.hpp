@@ -10,8 +10,9 @@ struct Player {
     * @brief Constructs a Player with the given identifier.
     * @param name A const. string reference to be the player name
     * @param level The current level of the Player
+    * @param id A unique identifier that stays with the Player as their level changes
     */
-    Player(const std::string& name="NONE", const size_t& level = 1);
+    Player(const std::string& name="NONE", const size_t& level = 1, const size_t& id = 0);
 
     /**
      * @brief Defines convenience comparators for Players, 
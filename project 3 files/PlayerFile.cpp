@@ -0,0 +1,378 @@
+#include "PlayerFile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace PlayerFile {
+
+namespace {
+
+/**
+ * @brief Parses a non-empty run of decimal digits.
+ *
+ * @param first The first character of the number.
+ * @param last One past its last character.
+ * @param value Set to the number parsed.
+ * @return True if [first, last) was a number that fits in a size_t, false otherwise.
+*/
+bool parseNumber(const char* first, const char* last, size_t& value) {
+    if (first == last) return false;
+    value = 0;
+    for (; first != last; ++first) {
+        if (*first < '0' || *first > '9') return false;
+        size_t digit = *first - '0';
+        if (value > (SIZE_MAX - digit) / 10) return false;
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the last comma in [first, last).
+ *
+ * @return A pointer to the comma, or nullptr if there is none.
+*/
+const char* findLastComma(const char* first, const char* last) {
+    while (last != first) {
+        if (*--last == ',') return last;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Strips every trailing '\r' from the line [first, last).
+ *
+ * @return const char* The new end of the line. A line of only '\r's is blank.
+*/
+const char* trimLineEnd(const char* first, const char* last) {
+    while (last != first && last[-1] == '\r') --last;
+    return last;
+}
+
+const char CSV_HEADER[] = "name,level,id";
+
+// The UTF-8 byte order mark some editors begin a CSV file with
+const char BYTE_ORDER_MARK[] = "\xEF\xBB\xBF";
+
+} // namespace
+
+/**
+ * @brief Encodes a Player as a fixed-width binary Record.
+ *
+ * @param player The Player to encode.
+ * @return Record The Record, with the name truncated to NAME_WIDTH bytes & NUL-padded.
+*/
+Record encode(const Player& player) {
+    Record record{};
+    record.level_ = player.level_;
+    record.id_ = player.id_;
+    std::memcpy(record.name_, player.name_.data(), std::min(player.name_.size(), NAME_WIDTH));
+    return record;
+}
+
+/**
+ * @brief Decodes a binary Record into a Player.
+ *
+ * @param record The Record to decode.
+ * @param out The Player to assign into.
+*/
+void decode(const Record& record, Player& out) {
+    out.level_ = record.level_;
+    out.id_ = record.id_;
+    const char* end = static_cast<const char*>(std::memchr(record.name_, '\0', NAME_WIDTH));
+    out.name_.assign(record.name_, end ? end : record.name_ + NAME_WIDTH);
+}
+
+/**
+ * @brief Parses a `name,level,id` CSV line from the right, so the name may contain commas.
+ *
+ * @param first The first character of the line.
+ * @param last One past its last character.
+ * @param out The Player to assign into.
+ * @return True if the line was well-formed.
+*/
+bool parseCsv(const char* first, const char* last, Player& out) {
+    const char* id_comma = findLastComma(first, last);
+    if (!id_comma) return false;
+    const char* level_comma = findLastComma(first, id_comma);
+    if (!level_comma) return false;
+
+    if (!parseNumber(id_comma + 1, last, out.id_)) return false;
+    if (!parseNumber(level_comma + 1, id_comma, out.level_)) return false;
+    out.name_.assign(first, level_comma);
+    return true;
+}
+
+/**
+ * @brief Creates a binary player file, writing a header with a count of 0 for now.
+ *
+ * @param path The path of the file.
+ * @throws std::runtime_error If the file cannot be created or written.
+*/
+Writer::Writer(const std::string& path)
+    : path_(path), file_(std::fopen(path.c_str(), "wb"), &std::fclose), count_(0) {
+    if (!file_) {
+        throw std::runtime_error("Cannot create player file " + path_);
+    }
+    std::setvbuf(file_.get(), nullptr, _IOFBF, READ_BUFFER_SIZE);
+
+    Header header{};
+    std::memcpy(header.magic_, MAGIC, sizeof(MAGIC));
+    if (std::fwrite(&header, sizeof(Header), 1, file_.get()) != 1) {
+        throw std::runtime_error("Cannot write player file " + path_);
+    }
+}
+
+/**
+ * @brief Appends one player's Record to the file.
+ *
+ * @param player The Player to write.
+ * @throws std::runtime_error If writing fails.
+*/
+void Writer::write(const Player& player) {
+    Record record = encode(player);
+    if (std::fwrite(&record, RECORD_SIZE, 1, file_.get()) != 1) {
+        throw std::runtime_error("Cannot write player file " + path_);
+    }
+    count_++;
+}
+
+/**
+ * @brief Patches the header's count and closes the file, if it is still open.
+ *
+ * @throws std::runtime_error If writing fails.
+*/
+void Writer::close() {
+    if (!file_) return;
+
+    Header header{};
+    std::memcpy(header.magic_, MAGIC, sizeof(MAGIC));
+    header.count_ = count_;
+    bool written = std::fseek(file_.get(), 0, SEEK_SET) == 0
+                   && std::fwrite(&header, sizeof(Header), 1, file_.get()) == 1;
+    if (std::fclose(file_.release()) != 0 || !written) {
+        throw std::runtime_error("Cannot write player file " + path_);
+    }
+}
+
+/**
+ * @brief Gets the number of players written so far.
+ *
+ * @return size_t The player count.
+*/
+size_t Writer::count() const {
+    return count_;
+}
+
+/**
+ * @brief Opens a player file, reading its header if binary, or counting its players if CSV.
+ *
+ * @param path The path of the file.
+ * @param buffer_size The number of bytes to read at once.
+ * @throws std::runtime_error If the file cannot be opened or read.
+*/
+Reader::Reader(const std::string& path, size_t buffer_size)
+    : path_(path), file_(std::fopen(path.c_str(), "rb"), &std::fclose), binary_(false), counted_(false), count_(0), read_(0),
+      buffer_(std::max(buffer_size, 2 * RECORD_SIZE)), begin_(0), end_(0), eof_(false) {
+    if (!file_) {
+        throw std::runtime_error("Cannot open player file " + path_);
+    }
+    std::setvbuf(file_.get(), nullptr, _IONBF, 0); // Reads already go through buffer_
+
+    fill();
+    if (end_ >= sizeof(Header) && std::memcmp(buffer_.data(), MAGIC, sizeof(MAGIC)) == 0) {
+        Header header;
+        std::memcpy(&header, buffer_.data(), sizeof(Header));
+        binary_ = true;
+        counted_ = true;
+        count_ = header.count_;
+        begin_ = sizeof(Header);
+        return;
+    }
+
+    // Skip a byte order mark, then the header if it is the first non-blank line
+    size_t mark_size = sizeof(BYTE_ORDER_MARK) - 1;
+    if (end_ >= mark_size && std::memcmp(buffer_.data(), BYTE_ORDER_MARK, mark_size) == 0) {
+        begin_ = mark_size;
+    }
+    const char* first;
+    const char* last;
+    if (nextLine(first, last)) {
+        size_t header_size = sizeof(CSV_HEADER) - 1;
+        if (size_t(last - first) != header_size || std::memcmp(first, CSV_HEADER, header_size) != 0) {
+            begin_ = first - buffer_.data(); // A player, so leave it to be read
+        }
+    }
+}
+
+/**
+ * @brief Gets whether the file is in the binary format.
+ *
+ * @return bool True if binary, false if CSV.
+*/
+bool Reader::binary() const {
+    return binary_;
+}
+
+/**
+ * @brief Gets the number of players in the file, counting a CSV file's lines on first use.
+ *
+ * @return size_t The player count.
+ * @throws std::runtime_error If counting needs to read the file and reading fails.
+*/
+size_t Reader::count() const {
+    if (!counted_) {
+        count_ = read_ + countLines();
+        counted_ = true;
+    }
+    return count_;
+}
+
+/**
+ * @brief Gets the number of players not yet read.
+ *
+ * @return size_t The count of players left to be read.
+*/
+size_t Reader::remaining() const {
+    return count() - read_;
+}
+
+/**
+ * @brief Decodes the next block of players out of the buffer, refilling it as needed.
+ *
+ * @param out Where to assign the Players.
+ * @param capacity The maximum number of Players to read.
+ * @return size_t The number of Players read.
+ * @throws std::runtime_error If the file ends early, a CSV line is malformed, or reading fails.
+*/
+size_t Reader::read(Player* out, size_t capacity) {
+    size_t count = binary_ ? std::min(capacity, remaining()) : capacity;
+    if (binary_) {
+        for (size_t i = 0; i < count;) {
+            if (end_ - begin_ < RECORD_SIZE && !fill()) {
+                throw std::runtime_error(path_ + " ends before its last player");
+            }
+            size_t ready = std::min(count - i, (end_ - begin_) / RECORD_SIZE);
+            for (; ready > 0; ready--, i++, begin_ += RECORD_SIZE) {
+                Record record;
+                std::memcpy(&record, buffer_.data() + begin_, RECORD_SIZE); // Records in the buffer may be misaligned
+                decode(record, out[i]);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            const char* first;
+            const char* last;
+            if (!nextLine(first, last)) {
+                // The end of a CSV file is found, not known in advance
+                count = i;
+                count_ = read_ + count;
+                counted_ = true;
+                break;
+            }
+            if (!parseCsv(first, last, out[i])) {
+                throw std::runtime_error(path_ + ": malformed player " + std::to_string(read_ + i + 1)
+                                         + ": " + std::string(first, last));
+            }
+        }
+    }
+    read_ += count;
+    return count;
+}
+
+/**
+ * @brief Moves the undecoded bytes to the front of the buffer and reads more behind them.
+ *
+ * @return bool True if any bytes were read, false at the end of the file.
+ * @throws std::runtime_error If reading fails.
+*/
+bool Reader::fill() {
+    if (eof_) return false;
+
+    size_t left = end_ - begin_;
+    std::memmove(buffer_.data(), buffer_.data() + begin_, left);
+    begin_ = 0;
+    end_ = left;
+    if (end_ == buffer_.size()) {
+        buffer_.resize(buffer_.size() * 2); // A single CSV line outgrew the buffer
+    }
+
+    size_t got = std::fread(buffer_.data() + end_, 1, buffer_.size() - end_, file_.get());
+    if (got == 0) {
+        if (std::ferror(file_.get())) {
+            throw std::runtime_error("Cannot read player file " + path_);
+        }
+        eof_ = true;
+        return false;
+    }
+    end_ += got;
+    return true;
+}
+
+/**
+ * @brief Finds the next non-blank line, refilling the buffer as needed.
+ *
+ * @param first Set to the first character of the line.
+ * @param last Set to one past its last character, excluding "\n" and any '\r's before it.
+ * @return bool True if a line was found, false at the end of the file.
+ * @note [first, last) stays valid until the next call.
+*/
+bool Reader::nextLine(const char*& first, const char*& last) {
+    for (;;) {
+        const char* data = buffer_.data();
+        const char* newline = static_cast<const char*>(std::memchr(data + begin_, '\n', end_ - begin_));
+        if (!newline) {
+            if (fill()) continue;
+            if (begin_ == end_) return false;
+            // The last line has no line ending
+            data = buffer_.data();
+            newline = data + end_;
+        }
+
+        first = data + begin_;
+        last = newline;
+        begin_ = std::min<size_t>(newline - data + 1, end_);
+        last = trimLineEnd(first, last);
+        if (last != first) return true;
+    }
+}
+
+/**
+ * @brief Counts the non-blank lines not yet decoded, those left in the buffer and the rest
+ *        of the file, with a pass of memchr() over their bytes.
+ *
+ * @return size_t The number of non-blank lines.
+ * @post The file's position and the buffer are as they were.
+ * @throws std::runtime_error If reading fails.
+*/
+size_t Reader::countLines() const {
+    size_t lines = 0;
+    bool blank = true;
+    auto scan = [&](const char* first, const char* last) {
+        while (first != last) {
+            const char* newline = static_cast<const char*>(std::memchr(first, '\n', last - first));
+            const char* end = newline ? newline : last;
+            // A line split across reads is blank only if each piece is, as trimLineEnd() would find
+            blank = blank && trimLineEnd(first, end) == first;
+            if (!newline) break;
+            lines += !blank;
+            blank = true;
+            first = newline + 1;
+        }
+    };
+
+    scan(buffer_.data() + begin_, buffer_.data() + end_);
+    if (!eof_) {
+        long position = std::ftell(file_.get());
+        std::vector<char> chunk(buffer_.size());
+        while (size_t got = std::fread(chunk.data(), 1, chunk.size(), file_.get())) {
+            scan(chunk.data(), chunk.data() + got);
+        }
+        if (std::ferror(file_.get()) || position < 0 || std::fseek(file_.get(), position, SEEK_SET) != 0) {
+            throw std::runtime_error("Cannot read player file " + path_);
+        }
+    }
+    return lines + !blank;
+}
+
+} // namespace PlayerFile
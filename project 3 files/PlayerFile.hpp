@@ -0,0 +1,199 @@
+#pragma once
+#include "Player.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief On-disk player tables, too large to load into a vector at once.
+ *
+ * A player file is in one of two formats, told apart by its first 8 bytes:
+ *
+ * 1) Binary: a Header (MAGIC, then the player count) followed by that many fixed-width
+ *    Records, all in host byte order. Every player is RECORD_SIZE bytes, so the n-th
+ *    one is at a known offset and a block of them decodes without any scanning.
+ *
+ * 2) CSV: one `name,level,id` line per player, e.g.
+ *        Malenia,99,7
+ *        Rykard,23,8
+ *    The level and id are the last two fields, so names may themselves contain commas.
+ *    An optional `name,level,id` header line (the first non-blank one, after an optional
+ *    UTF-8 byte order mark), blank lines & "\r\n" endings are allowed.
+ *    Any '\r's ending a line are stripped, so a line of only '\r's is blank.
+ */
+namespace PlayerFile {
+
+/**
+ * @brief The widest name a binary Record stores; longer names are truncated.
+ */
+const size_t NAME_WIDTH = 48;
+
+/**
+ * @brief The first 8 bytes of every binary player file.
+ */
+const char MAGIC[8] = {'P', 'L', 'A', 'Y', 'E', 'R', 'S', '1'};
+
+/**
+ * @brief The header of a binary player file.
+ */
+struct Header {
+    char magic_[8];
+    uint64_t count_;
+};
+
+/**
+ * @brief One player of a binary player file. The name is NUL-padded, and is
+ * not NUL-terminated if it fills all NAME_WIDTH bytes.
+ */
+struct Record {
+    uint64_t level_;
+    uint64_t id_;
+    char name_[NAME_WIDTH];
+};
+
+const size_t RECORD_SIZE = sizeof(Record);
+
+/**
+ * @brief The default number of bytes a Reader buffers per read.
+ */
+const size_t READ_BUFFER_SIZE = 1 << 20;
+
+/**
+ * @brief Encodes a Player as a binary Record.
+ * @param player The Player to encode. Its name is truncated to NAME_WIDTH bytes.
+ * @return The Record.
+ */
+Record encode(const Player& player);
+
+/**
+ * @brief Decodes a binary Record into a Player.
+ * @param record The Record to decode.
+ * @param out The Player to assign into. Its name's storage is reused if large enough.
+ */
+void decode(const Record& record, Player& out);
+
+/**
+ * @brief Parses one CSV line of the form `name,level,id`.
+ * @param first A pointer to the first character of the line.
+ * @param last A pointer to one past its last character, excluding the line ending.
+ * @param out The Player to assign into. Its name's storage is reused if large enough.
+ * @return True if the line was well-formed, false otherwise (`out` is then unspecified).
+ */
+bool parseCsv(const char* first, const char* last, Player& out);
+
+/**
+ * @brief Writes a binary player file, one player at a time.
+ *
+ * Records go through a READ_BUFFER_SIZE stdio buffer. The header's count is
+ * written as 0 up front and patched by close(), so an unclosed file reads as empty.
+ */
+class Writer {
+public:
+    /**
+     * @brief Creates (or truncates) a binary player file and writes its header.
+     * @param path The path of the file.
+     * @throws std::runtime_error If the file cannot be created or written.
+     */
+    Writer(const std::string& path);
+
+    /**
+     * @brief Appends a player to the file.
+     * @param player The Player to write. Its name is truncated to NAME_WIDTH bytes.
+     * @throws std::runtime_error If writing fails.
+     */
+    void write(const Player& player);
+
+    /**
+     * @brief Records the number of players written in the header and closes the file.
+     *      Closing an already closed Writer does nothing.
+     * @throws std::runtime_error If writing fails.
+     * @post No more players may be written.
+     */
+    void close();
+
+    /**
+     * @brief Retrieves the number of players written so far.
+     */
+    size_t count() const;
+
+private:
+    std::string path_;
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file_;
+    size_t count_;
+};
+
+/**
+ * @brief Reads the players of a binary or CSV player file sequentially, in chunks.
+ *
+ * The file is read READ_BUFFER_SIZE bytes at a time into one reused buffer, and players
+ * are decoded straight out of it, so memory stays constant however large the file is.
+ * A binary file's count is in its header. A CSV file is read in one pass unless its
+ * count is asked for before its end, which costs one extra pass over the rest of it.
+ */
+class Reader {
+public:
+    /**
+     * @brief Opens a player file and reads its header (or skips a CSV file's header line).
+     * @param path The path of the file.
+     * @param buffer_size The number of bytes to read at once (> RECORD_SIZE).
+     * @throws std::runtime_error If the file cannot be opened or read.
+     */
+    Reader(const std::string& path, size_t buffer_size = READ_BUFFER_SIZE);
+
+    /**
+     * @brief Retrieves whether the file is in the binary format (rather than CSV).
+     */
+    bool binary() const;
+
+    /**
+     * @brief Retrieves the number of players in the file.
+     *
+     * A binary file records it in its header. A CSV file's count is only known once it
+     * has been read to the end, so until then the first call counts the unread lines,
+     * with an extra pass over the rest of the file.
+     * @throws std::runtime_error If counting fails to read the file.
+     */
+    size_t count() const;
+
+    /**
+     * @brief Retrieves the number of players not yet read, counting as count() does.
+     * @throws std::runtime_error If counting fails to read the file.
+     */
+    size_t remaining() const;
+
+    /**
+     * @brief Decodes up to `capacity` of the next players in the file.
+     * @param out A pointer to the first of `capacity` Players to assign into.
+     * @param capacity The maximum number of Players to read.
+     * @return The number of Players assigned into out[0, return), which is
+     *      min(capacity, remaining()). 0 means the whole file has been read.
+     * @throws std::runtime_error If the file ends early, a CSV line is malformed, or reading fails.
+     */
+    size_t read(Player* out, size_t capacity);
+
+private:
+    std::string path_;
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file_;
+    bool binary_;
+    mutable bool counted_; // Whether count_ is known yet
+    mutable size_t count_;
+    size_t read_;
+
+    // buffer_[begin_, end_) holds the bytes read from the file but not yet decoded
+    std::vector<char> buffer_;
+    size_t begin_;
+    size_t end_;
+    bool eof_;
+
+    // Keeps the undecoded bytes & reads more behind them. Returns false if none could be read.
+    bool fill();
+
+    // Finds the next non-blank line, setting [first, last) to it without its line ending
+    bool nextLine(const char*& first, const char*& last);
+
+    // Counts the non-blank lines not yet decoded, leaving the file's position & buffer as they were
+    size_t countLines() const;
+};
+}
@@ -1,5 +1,26 @@
 #include "PlayerStream.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
 #include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Default block adapter: retrieves the next Players one at a time.
+ *
+ * @param out Where to assign the retrieved Players.
+ * @param capacity The maximum number of Players to retrieve.
+ * @return The number of Players retrieved.
+*/
+size_t PlayerStream::nextBatch(Player* out, size_t capacity) {
+    size_t count = std::min(capacity, remaining());
+    for (size_t i = 0; i < count; i++) {
+        out[i] = nextPlayer();
+    }
+    return count;
+}
 
 /**
  * @brief Constructs a VectorPlayerStream from an existing vector of Players.
@@ -11,6 +32,16 @@
 VectorPlayerStream::VectorPlayerStream(const std::vector<Player>& players) 
     : players_(players), current_(0) {}
 
+/**
+ * @brief Constructs a VectorPlayerStream by moving from a vector of Players.
+ *
+ * @param players The vector of Player objects to be streamed.
+ * @post The stream is initialized to return players in their original order,
+ *       starting from the first element, and `players` has been moved from.
+*/
+VectorPlayerStream::VectorPlayerStream(std::vector<Player>&& players)
+    : players_(std::move(players)), current_(0) {}
+
 /**
  * @brief Retrieves the next Player in the stream.
  *
@@ -22,7 +53,7 @@ Player VectorPlayerStream::nextPlayer() {
     if (current_ >= players_.size()) {
         throw std::runtime_error("No more players in stream");
     }
-    return players_[current_++];
+    return std::move(players_[current_++]); // Each Player is read once, so it can be given away
 }
 
 /**
@@ -33,4 +64,504 @@ Player VectorPlayerStream::nextPlayer() {
 */
 size_t VectorPlayerStream::remaining() const {
     return players_.size() - current_;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Moves the next block of Players out of the stream's vector.
+ *
+ * @param out Where to move the Players.
+ * @param capacity The maximum number of Players to move.
+ * @return The number of Players moved.
+*/
+size_t VectorPlayerStream::nextBatch(Player* out, size_t capacity) {
+    size_t count = std::min(capacity, remaining());
+    std::move(players_.begin() + current_, players_.begin() + current_ + count, out);
+    current_ += count;
+    return count;
+}
+
+/**
+ * @brief Constructs a SpanPlayerStream over an existing range of Players.
+ *
+ * @param first The first Player to be streamed.
+ * @param last One past the last Player to be streamed.
+*/
+SpanPlayerStream::SpanPlayerStream(Player* first, Player* last)
+    : current_(first), last_(last) {}
+
+/**
+ * @brief Constructs a SpanPlayerStream over an existing vector of Players.
+ *
+ * @param players The vector of Player objects to be streamed.
+*/
+SpanPlayerStream::SpanPlayerStream(std::vector<Player>& players)
+    : SpanPlayerStream(players.data(), players.data() + players.size()) {}
+
+/**
+ * @brief Moves the next Player out of the range.
+ *
+ * @return The next Player object in the sequence.
+ * @post The stream position advances to the next player.
+ * @throws std::runtime_error if called when no more players are remaining.
+*/
+Player SpanPlayerStream::nextPlayer() {
+    if (current_ == last_) {
+        throw std::runtime_error("No more players in stream");
+    }
+    return std::move(*current_++);
+}
+
+/**
+ * @brief Returns the number of players remaining in the range.
+ *
+ * @return The count of players left to be read from the stream.
+*/
+size_t SpanPlayerStream::remaining() const {
+    return last_ - current_;
+}
+
+/**
+ * @brief Moves the next block of Players out of the range.
+ *
+ * @param out Where to move the Players.
+ * @param capacity The maximum number of Players to move.
+ * @return The number of Players moved.
+*/
+size_t SpanPlayerStream::nextBatch(Player* out, size_t capacity) {
+    size_t count = std::min(capacity, remaining());
+    std::move(current_, current_ + count, out);
+    current_ += count;
+    return count;
+}
+
+/**
+ * @brief Maps a binary player file into memory and checks its header.
+ *
+ * @param path The path of the file.
+ * @throws std::runtime_error If the file cannot be mapped or isn't a complete binary player file.
+*/
+MmapPlayerStream::MmapPlayerStream(const std::string& path)
+    : mapping_(nullptr), mapping_size_(0), current_(nullptr), last_(nullptr) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open player file " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot open player file " + path);
+    }
+
+    mapping_size_ = info.st_size;
+    if (mapping_size_ < sizeof(PlayerFile::Header)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a binary player file");
+    }
+    mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file open
+    if (mapping_ == MAP_FAILED) {
+        throw std::runtime_error("Cannot map player file " + path);
+    }
+    ::madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+
+    const PlayerFile::Header* header = static_cast<const PlayerFile::Header*>(mapping_);
+    size_t capacity = (mapping_size_ - sizeof(PlayerFile::Header)) / PlayerFile::RECORD_SIZE;
+    if (std::memcmp(header->magic_, PlayerFile::MAGIC, sizeof(PlayerFile::MAGIC)) != 0
+        || header->count_ > capacity) {
+        ::munmap(mapping_, mapping_size_);
+        throw std::runtime_error(path + " is not a complete binary player file");
+    }
+
+    // The mapping is page-aligned & the header is 16 bytes, so every Record is aligned
+    current_ = reinterpret_cast<const PlayerFile::Record*>(header + 1);
+    last_ = current_ + header->count_;
+}
+
+/**
+ * @brief Unmaps the file.
+*/
+MmapPlayerStream::~MmapPlayerStream() {
+    ::munmap(mapping_, mapping_size_);
+}
+
+/**
+ * @brief Decodes the next Record.
+ *
+ * @return The next Player object in the file.
+ * @post The stream position advances to the next player.
+ * @throws std::runtime_error if called when no more players are remaining.
+*/
+Player MmapPlayerStream::nextPlayer() {
+    if (current_ == last_) {
+        throw std::runtime_error("No more players in stream");
+    }
+    Player player;
+    PlayerFile::decode(*current_++, player);
+    return player;
+}
+
+/**
+ * @brief Returns the number of Records not yet decoded.
+ *
+ * @return The count of players left to be read from the stream.
+*/
+size_t MmapPlayerStream::remaining() const {
+    return last_ - current_;
+}
+
+/**
+ * @brief Decodes the next block of Records.
+ *
+ * @param out Where to decode the Players.
+ * @param capacity The maximum number of Players to decode.
+ * @return The number of Players decoded.
+*/
+size_t MmapPlayerStream::nextBatch(Player* out, size_t capacity) {
+    size_t count = std::min(capacity, remaining());
+    for (size_t i = 0; i < count; i++) {
+        PlayerFile::decode(current_[i], out[i]);
+    }
+    current_ += count;
+    return count;
+}
+
+/**
+ * @brief Opens a CSV player file and skips its header line, if any.
+ *
+ * @param path The path of the file.
+ * @param buffer_size The number of bytes to read at once.
+ * @throws std::runtime_error If the file cannot be read, or is a binary player file.
+*/
+CsvPlayerStream::CsvPlayerStream(const std::string& path, size_t buffer_size)
+    : reader_(path, buffer_size) {
+    if (reader_.binary()) {
+        throw std::runtime_error(path + " is a binary player file; use MmapPlayerStream");
+    }
+}
+
+/**
+ * @brief Parses the next line.
+ *
+ * @return The next Player object in the file.
+ * @post The stream position advances to the next player.
+ * @throws std::runtime_error if called when no more players are remaining.
+*/
+Player CsvPlayerStream::nextPlayer() {
+    Player player;
+    if (reader_.read(&player, 1) == 0) {
+        throw std::runtime_error("No more players in stream");
+    }
+    return player;
+}
+
+/**
+ * @brief Returns the number of lines not yet parsed, counting them on the first call.
+ *
+ * @return The count of players left to be read from the stream.
+*/
+size_t CsvPlayerStream::remaining() const {
+    return reader_.remaining();
+}
+
+/**
+ * @brief Parses the next block of lines.
+ *
+ * @param out Where to parse the Players.
+ * @param capacity The maximum number of Players to parse.
+ * @return The number of Players parsed.
+*/
+size_t CsvPlayerStream::nextBatch(Player* out, size_t capacity) {
+    return reader_.read(out, capacity);
+}
+
+#ifdef API_ENABLED
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Constructs an APIPlayerStream and issues its first requests.
+ *
+ * @param expected_length The total number of Player objects expected from the API.
+ * @param seed The seed passed with every request.
+ * @param batch_size The number of Player objects to fetch per request.
+ * @param in_flight The number of requests to keep outstanding at once.
+*/
+APIPlayerStream::APIPlayerStream(const size_t& expected_length, const size_t& seed, const size_t& batch_size, const size_t& in_flight)
+    : cursor_(1), seed_(seed), batch_size_(batch_size), remaining_(expected_length),
+      request_cursor_(1), unrequested_(expected_length), in_flight_(std::max<size_t>(in_flight, 1)),
+      next_session_(0), next_level_(0) {
+    // Open no more connections than there are requests to make
+    size_t sessions = std::min(in_flight_, (expected_length + batch_size - 1) / batch_size);
+    for (size_t i = 0; i < sessions; i++) {
+        sessions_.push_back(std::make_shared<cpr::Session>());
+        sessions_.back()->SetUrl(cpr::Url{SOCKET + "/api"});
+    }
+    levels_.reserve(batch_size);
+    requestBatches();
+}
+
+/**
+ * @brief Tops up the outstanding requests with the next cursor windows.
+*/
+void APIPlayerStream::requestBatches() {
+    while (pending_.size() < in_flight_ && unrequested_ > 0) {
+        size_t batch = std::min(batch_size_, unrequested_);
+
+        // This slot's previous request has been received, so its session is idle
+        std::shared_ptr<cpr::Session>& session = sessions_[next_session_];
+        next_session_ = (next_session_ + 1) % sessions_.size();
+
+        session->SetParameters(cpr::Parameters{
+            {"seed", std::to_string(seed_)},
+            {"cursor", std::to_string(request_cursor_)},
+            {"batch", std::to_string(batch)}
+        });
+        pending_.push_back(session->GetAsync());
+        request_cursor_ += batch;
+        unrequested_ -= batch;
+    }
+}
+
+/**
+ * @brief Waits for the oldest outstanding request, parses it into the current batch,
+ * and issues the next request in its place.
+ *
+ * @throws std::runtime_error If the request failed or returned no levels.
+*/
+void APIPlayerStream::receiveBatch() {
+    if (pending_.empty()) {
+        throw std::runtime_error("No more players in stream");
+    }
+    cpr::Response response = pending_.front().get();
+    pending_.pop_front();
+    requestBatches();
+
+    if (response.status_code != 200) {
+        throw std::runtime_error("API request failed (" + std::to_string(response.status_code) + "): " + response.error.message);
+    }
+
+    if (!parseBatch(response.text, levels_, cursor_)) {
+        throw std::runtime_error("API returned a malformed batch: " + response.text);
+    }
+    next_level_ = 0;
+
+    if (levels_.empty()) {
+        throw std::runtime_error("API returned an empty batch");
+    }
+}
+
+namespace {
+
+/**
+ * @brief Just enough of a JSON reader for a batch response: unsigned integers,
+ * arrays of them, and skipping any other value.
+ */
+class BatchReader {
+public:
+    BatchReader(const std::string& body) : p_(body.data()), end_(body.data() + body.size()) {}
+
+    void skipSpace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) p_++;
+    }
+
+    // Skips whitespace, then consumes `c` if it is next
+    bool consume(char c) {
+        skipSpace();
+        if (p_ == end_ || *p_ != c) return false;
+        p_++;
+        return true;
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return p_ == end_;
+    }
+
+    // Parses a non-negative integer, failing if it does not fit in a size_t
+    bool parseNumber(size_t& value) {
+        skipSpace();
+        if (p_ == end_ || *p_ < '0' || *p_ > '9') return false;
+        value = 0;
+        for (; p_ < end_ && *p_ >= '0' && *p_ <= '9'; p_++) {
+            size_t digit = *p_ - '0';
+            if (value > (SIZE_MAX - digit) / 10) return false;
+            value = value * 10 + digit;
+        }
+        return true;
+    }
+
+    // Parses an array of non-negative integers into `out`, which is cleared first
+    bool parseNumbers(std::vector<size_t>& out) {
+        out.clear();
+        if (!consume('[')) return false;
+        if (consume(']')) return true;
+        do {
+            size_t value;
+            if (!parseNumber(value)) return false;
+            out.push_back(value);
+        } while (consume(','));
+        return consume(']');
+    }
+
+    // Parses a string, setting `text` to its raw contents (escapes are left as is)
+    bool parseString(std::string_view& text) {
+        if (!consume('"')) return false;
+        const char* first = p_;
+        for (; p_ < end_ && *p_ != '"'; p_++) {
+            if (*p_ == '\\' && ++p_ == end_) return false;
+        }
+        if (p_ == end_) return false;
+        text = std::string_view(first, p_++ - first);
+        return true;
+    }
+
+    // Skips any value: a string, number, literal, or an object or array nested up to MAX_DEPTH deep
+    bool skipValue(size_t depth = 0) {
+        skipSpace();
+        if (p_ == end_) return false;
+        std::string_view text;
+        switch (*p_) {
+        case '"':
+            return parseString(text);
+        case '[':
+            if (depth == MAX_DEPTH) return false;
+            p_++;
+            if (consume(']')) return true;
+            do {
+                if (!skipValue(depth + 1)) return false;
+            } while (consume(','));
+            return consume(']');
+        case '{':
+            if (depth == MAX_DEPTH) return false;
+            p_++;
+            if (consume('}')) return true;
+            do {
+                if (!parseString(text) || !consume(':') || !skipValue(depth + 1)) return false;
+            } while (consume(','));
+            return consume('}');
+        default:
+            return skipScalar();
+        }
+    }
+
+private:
+    static const size_t MAX_DEPTH = 64;
+
+    const char* p_;
+    const char* end_;
+
+    // Skips a literal (true, false or null) or a number, with any sign, fraction or exponent
+    bool skipScalar() {
+        for (const char* literal : {"true", "false", "null"}) {
+            size_t length = std::strlen(literal);
+            if (static_cast<size_t>(end_ - p_) >= length && std::memcmp(p_, literal, length) == 0) {
+                p_ += length;
+                return true;
+            }
+        }
+        if (p_ < end_ && *p_ == '-') p_++;
+        if (!skipDigits()) return false;
+        if (p_ < end_ && *p_ == '.') {
+            p_++;
+            if (!skipDigits()) return false;
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            p_++;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) p_++;
+            if (!skipDigits()) return false;
+        }
+        return true;
+    }
+
+    bool skipDigits() {
+        const char* first = p_;
+        while (p_ < end_ && *p_ >= '0' && *p_ <= '9') p_++;
+        return p_ != first;
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Parses a batch response body without building a JSON document.
+ *
+ * @param body The response body.
+ * @param levels Filled with the batch's levels.
+ * @param cursor Set to the cursor following the batch.
+ * @return True if the body was one JSON object holding a "levels" array and a "cursor".
+*/
+bool APIPlayerStream::parseBatch(const std::string& body, std::vector<size_t>& levels, size_t& cursor) {
+    BatchReader reader(body);
+    levels.clear();
+    bool has_levels = false;
+    bool has_cursor = false;
+
+    if (!reader.consume('{')) return false;
+    if (!reader.consume('}')) {
+        do {
+            std::string_view name;
+            if (!reader.parseString(name) || !reader.consume(':')) return false;
+            if (name == "levels") {
+                if (!reader.parseNumbers(levels)) return false;
+                has_levels = true;
+            } else if (name == "cursor") {
+                if (!reader.parseNumber(cursor)) return false;
+                has_cursor = true;
+            } else if (!reader.skipValue()) {
+                return false;
+            }
+        } while (reader.consume(','));
+        if (!reader.consume('}')) return false;
+    }
+    return reader.atEnd() && has_levels && has_cursor;
+}
+
+/**
+ * @brief Retrieves the next Player, receiving the next batch if the current one is exhausted.
+ *
+ * @return The next Player object in the sequence.
+ * @throws std::runtime_error if no players remain or an API request fails.
+*/
+Player APIPlayerStream::nextPlayer() {
+    if (remaining_ == 0) {
+        throw std::runtime_error("No more players in stream");
+    }
+    if (next_level_ == levels_.size()) {
+        receiveBatch();
+    }
+    remaining_--;
+    size_t position = cursor_ - levels_.size() + next_level_;
+    return Player("API_" + std::to_string(position), levels_[next_level_++], position);
+}
+
+/**
+ * @brief Returns the number of players remaining in the stream.
+ *
+ * @return The count of players left to be read from the stream.
+*/
+size_t APIPlayerStream::remaining() const {
+    return remaining_;
+}
+
+/**
+ * @brief Retrieves the next block of Players, receiving batches as needed.
+ *
+ * @param out Where to assign the Players.
+ * @param capacity The maximum number of Players to retrieve.
+ * @return The number of Players retrieved.
+*/
+size_t APIPlayerStream::nextBatch(Player* out, size_t capacity) {
+    size_t count = std::min(capacity, remaining_);
+    for (size_t i = 0; i < count; i++) {
+        if (next_level_ == levels_.size()) {
+            receiveBatch();
+        }
+        size_t position = cursor_ - levels_.size() + next_level_;
+        out[i].name_ = "API_" + std::to_string(position);
+        out[i].level_ = levels_[next_level_++];
+        out[i].id_ = position;
+        remaining_--;
+    }
+    return count;
+}
+#endif
@@ -1,8 +1,19 @@
 #pragma once
 #include "Player.hpp"
+#include "PlayerFile.hpp"
 #include <stdexcept>
+#include <string>
 #include <vector>
 
+// APIPlayerStream needs cpr: the CMake build defines API_ENABLED for each target linking it,
+// while the plain Makefile build has no cpr and so omits APIPlayerStream.
+#ifdef API_ENABLED
+#include <cpr/cpr.h>
+#include <deque>
+#include <memory>
+#include <string>
+#endif
+
 /**
  * @brief Interface for fetching Player objects sequentially.
  */
@@ -28,6 +39,21 @@ public:
      * @return The count of players left to be read.
      */
     virtual size_t remaining() const = 0;
+
+    /**
+     * @brief Retrieves up to `capacity` of the next Players in the stream at once.
+     *
+     * Lets a consumer pay for one virtual call per block instead of two or three
+     * per Player. The default adapter simply calls nextPlayer() for each one;
+     * streams that can hand out a block more cheaply should override it.
+     *
+     * @param out A pointer to the first of `capacity` Players to assign into.
+     * @param capacity The maximum number of Players to retrieve.
+     * @return The number of Players assigned into out[0, return), which is
+     *      min(capacity, remaining()). 0 means the stream is exhausted.
+     * @post Updates stream members as if nextPlayer() were called that many times.
+     */
+    virtual size_t nextBatch(Player* out, size_t capacity);
 };
 
 /**
@@ -64,10 +90,20 @@ public:
      */
     VectorPlayerStream(const std::vector<Player>& players);
 
+    /**
+     * @brief Constructs a VectorPlayerStream by taking over a vector of Players.
+     *
+     * Unlike the copying constructor, no Player is copied.
+     *
+     * @param players An r-value ref. to the vector of Player objects to stream.
+     * @post `players` is left valid but unspecified (in practice, empty).
+     */
+    VectorPlayerStream(std::vector<Player>&& players);
+
     /**
     * @brief Retrieves the next Player in the stream.
     *
-    * @return The next Player object in the sequence.
+    * @return The next Player object in the sequence, moved out of the stream's own vector.
     * @post Updates members so a subsequent call to nextPlayer() yields the Player
     * following that which is returned.
 
@@ -81,4 +117,338 @@ public:
      * @return The count of players left to be read.
      */
     size_t remaining() const override; // see how many instances remaining to be fetched
+
+    /**
+     * @brief Moves up to `capacity` of the next Players out of the stream in one call.
+     *
+     * @param out A pointer to the first of `capacity` Players to assign into.
+     * @param capacity The maximum number of Players to retrieve.
+     * @return The number of Players moved into `out`. 0 once the stream is exhausted.
+     */
+    size_t nextBatch(Player* out, size_t capacity) override;
+};
+
+/**
+ * @brief A non-owning PlayerStream over a contiguous range of Players.
+ *
+ * Nothing is copied when the stream is created: it only views the range
+ * [first, last), which must outlive the stream. Each call to nextPlayer()
+ * moves the next Player out of the range, so a whole vector can be
+ * streamed into a ranker without copying a single name.
+ *
+ * @example Given a vector of Player objects v = {
+ *      Player("Rykard", 23),
+ *      Player("Malenia", 99)
+ *  }
+ *
+ * SpanPlayerStream stream(v);
+ * stream.remaining() -> 2
+ * stream.nextPlayer() -> Player("Rykard", 23)  (v[0] is now moved-from)
+ * stream.nextPlayer() -> Player("Malenia", 99) (v[1] is now moved-from)
+ * stream.remaining() -> 0
+ * stream.nextPlayer() -> throws std::runtime_error()
+ */
+class SpanPlayerStream : public PlayerStream {
+private:
+    Player* current_;
+    Player* last_;
+
+public:
+    /**
+     * @brief Constructs a SpanPlayerStream over the range [first, last).
+     *
+     * @param first A pointer to the first Player to stream.
+     * @param last A pointer to one past the last Player to stream.
+     */
+    SpanPlayerStream(Player* first, Player* last);
+
+    /**
+     * @brief Constructs a SpanPlayerStream over the whole of a vector.
+     *
+     * @param players The vector of Player objects to stream. It must not be
+     *      resized or destroyed while the stream is in use.
+     */
+    SpanPlayerStream(std::vector<Player>& players);
+
+    /**
+    * @brief Retrieves the next Player in the stream.
+    *
+    * @return The next Player object in the range, moved out of it.
+    * @post The Player in the range is left valid but unspecified, and
+    * a subsequent call to nextPlayer() yields the Player following it.
+    *
+    * @throws std::runtime_error If there are no more players remaining in the stream.
+    */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     *
+     * @return The count of players left to be read.
+     */
+    size_t remaining() const override;
+
+    /**
+     * @brief Moves up to `capacity` of the next Players out of the range in one call.
+     *
+     * @param out A pointer to the first of `capacity` Players to assign into.
+     * @param capacity The maximum number of Players to retrieve.
+     * @return The number of Players moved into `out`. 0 once the stream is exhausted.
+     */
+    size_t nextBatch(Player* out, size_t capacity) override;
+};
+
+/**
+ * @brief A PlayerStream over a binary player file (see PlayerFile.hpp), mapped into memory.
+ *
+ * The whole file is mapped with mmap() once, read-only, and each Record is decoded
+ * straight out of the mapping, so nothing but the current Player is copied and memory
+ * stays constant however large the file is. The kernel is told the file will be read
+ * sequentially, so it reads ahead of the stream & drops pages behind it.
+ *
+ * @example Given a file written by `player_convert players.csv players.bin`:
+ *
+ * MmapPlayerStream stream("players.bin");
+ * Online::rankIncoming(stream, 100);
+ */
+class MmapPlayerStream : public PlayerStream {
+private:
+    void* mapping_;
+    size_t mapping_size_;
+    const PlayerFile::Record* current_;
+    const PlayerFile::Record* last_;
+
+public:
+    /**
+     * @brief Maps a binary player file and checks its header.
+     *
+     * @param path The path of the file.
+     * @throws std::runtime_error If the file cannot be opened or mapped, isn't a binary
+     *      player file, or is shorter than its header says.
+     */
+    MmapPlayerStream(const std::string& path);
+
+    MmapPlayerStream(const MmapPlayerStream&) = delete;
+    MmapPlayerStream& operator=(const MmapPlayerStream&) = delete;
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MmapPlayerStream() override;
+
+    /**
+    * @brief Retrieves the next Player in the file.
+    *
+    * @return The next Player object, decoded from its Record.
+    * @throws std::runtime_error If there are no more players remaining in the stream.
+    */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     *
+     * @return The count of players left to be read.
+     */
+    size_t remaining() const override;
+
+    /**
+     * @brief Decodes up to `capacity` of the next Records in one call.
+     *
+     * @param out A pointer to the first of `capacity` Players to assign into.
+     * @param capacity The maximum number of Players to retrieve.
+     * @return The number of Players decoded into `out`. 0 once the stream is exhausted.
+     */
+    size_t nextBatch(Player* out, size_t capacity) override;
+};
+
+/**
+ * @brief A PlayerStream over a CSV player file (see PlayerFile.hpp).
+ *
+ * Lines are parsed by hand out of a reused buffer filled with large reads
+ * (via PlayerFile::Reader) rather than through an iostream, so memory stays
+ * constant however large the file is. Streaming it reads the file once: a CSV file
+ * has no count, so remaining() counts the lines left with an extra pass of memchr()
+ * over them the first time it is called before the end.
+ */
+class CsvPlayerStream : public PlayerStream {
+private:
+    PlayerFile::Reader reader_;
+
+public:
+    /**
+     * @brief Opens a CSV player file and skips its header line, if any.
+     *
+     * @param path The path of the file.
+     * @param buffer_size The number of bytes to read at once. Defaults to 1 MiB.
+     * @throws std::runtime_error If the file cannot be opened or read, or is a binary player file.
+     */
+    CsvPlayerStream(const std::string& path, size_t buffer_size = PlayerFile::READ_BUFFER_SIZE);
+
+    /**
+    * @brief Retrieves the next Player in the file.
+    *
+    * @return The next Player object, parsed from its line.
+    * @throws std::runtime_error If there are no more players remaining in the stream,
+    *      or the line is malformed.
+    */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     *
+     * @return The count of players left to be read.
+     */
+    size_t remaining() const override;
+
+    /**
+     * @brief Parses up to `capacity` of the next lines in one call.
+     *
+     * @param out A pointer to the first of `capacity` Players to assign into.
+     * @param capacity The maximum number of Players to retrieve.
+     * @return The number of Players parsed into `out`. 0 once the stream is exhausted.
+     * @throws std::runtime_error If a line is malformed or reading fails.
+     */
+    size_t nextBatch(Player* out, size_t capacity) override;
+};
+
+#ifdef API_ENABLED
+/**
+ * @brief A PlayerStream implementation that fetches Player objects from an API in batches.
+ *
+ * Specifically, this retrieves Player objects localhost (127.0.0.1) at port 5000 using HTTP requests
+ * to fetch subequent batches of Players of specified size, via:
+ * http://127.0.0.1:5000/api?seed={POSITIVE NUMBER}&cursor={CURSOR}&batch={BATCH_SIZE}
+ *
+ * which returns a JSON body of the form { "cursor": 6, "levels": [ 10, 20, 23, 1, 389 ] }
+ *
+ * The server caps a batch at 10 players, so waiting on one request at a time stalls the
+ * reader for a full round-trip every 10 players. Instead, the stream keeps up to
+ * `in_flight` requests outstanding (via cpr::GetAsync), each for the next cursor window.
+ * The requests are queued in cursor order, so responses are consumed in order no matter
+ * which one arrives first. Each time a batch is consumed, the request for the next
+ * unrequested window is issued, so later batches load while earlier ones are read.
+ *
+ * Each outstanding request has its own cpr::Session, reused for every request in that slot,
+ * so its HTTP/1.1 keep-alive connection is reused instead of reconnecting per batch.
+ * Responses are parsed by hand straight into a reused buffer of levels, with no allocation.
+ */
+class APIPlayerStream : public PlayerStream {
+protected:
+    const std::string PORT = "5000";
+    const std::string HOSTNAME = "http://127.0.0.1";
+    const std::string SOCKET = HOSTNAME + ":" + PORT;
+
+private:
+    /**
+     * @brief Imagine you're querying from a database and there's millions of results
+     * Instead, of returning all million of them, we'll periodically fetch a batch of them,
+     * and store where in that sequence of million results we're at.
+     * `cursor_` is *exactly* this: the cursor returned by the last batch received.
+     */
+    size_t cursor_;
+
+    /**
+     * @brief Since we're not working with an actual database,
+     * we'll use seeds to pseudo-randomly generate contents.
+     */
+    size_t seed_;
+
+    // The number of players requested per call
+    size_t batch_size_;
+
+    // The number of players not yet handed out
+    size_t remaining_;
+
+    // The cursor & number of players of the next window to request
+    size_t request_cursor_;
+    size_t unrequested_;
+
+    // The maximum number of requests outstanding at once
+    size_t in_flight_;
+
+    // Outstanding requests, in cursor order
+    std::deque<cpr::AsyncResponse> pending_;
+
+    // One keep-alive session per outstanding request; request i is sent on sessions_[i % in_flight_]
+    std::vector<std::shared_ptr<cpr::Session>> sessions_;
+    size_t next_session_;
+
+    // The levels of the batch being read, and the next one to hand out
+    std::vector<size_t> levels_;
+    size_t next_level_;
+
+    // Issues requests for the next windows until `in_flight_` are outstanding (or none are left)
+    void requestBatches();
+
+    // Waits for the oldest outstanding request and makes its levels the current batch
+    void receiveBatch();
+
+public:
+    /**
+     * @brief Parses a response body of the form { "levels": [10, 20], "cursor": 6 }.
+     *
+     * Whitespace and key order are free, and unknown keys are skipped whatever their value
+     * (strings, numbers, literals, or objects & arrays nested up to 64 deep).
+     *
+     * @param body The response body.
+     * @param levels The vector to fill with the batch's levels; cleared first, but keeps its capacity.
+     * @param cursor Set to the cursor following the batch.
+     * @return True if the body is one object in which both keys were found & well-formed,
+     *      false otherwise. A level or cursor that does not fit in a size_t is malformed.
+     */
+    static bool parseBatch(const std::string& body, std::vector<size_t>& levels, size_t& cursor);
+
+public:
+    /**
+     * @brief Constructs an APIPlayerStream that fetches Players from an API and presents the contents as a stream
+     *
+     * @pre All parameters are positive (ie. > 0). Also, for simplicitly assume that expected_length is a multiple of batch_size
+     *
+     * @param expected_length The total number of Player objects expected from the API.
+     * @param seed A seed value used for API requests to ensure consistent results
+     * @param batch_size The number of Player objects to fetch in each API request.
+     * @param in_flight The number of requests to keep outstanding at once. Defaults to 8.
+     *
+     * @post
+     * a) `cursor_` is initialized to 1
+     * b) `seed_` is initialized to the provided seed value.
+     * c) The first `in_flight` requests have been issued.
+     */
+    APIPlayerStream(const size_t& expected_length, const size_t& seed, const size_t& batch_size = 5, const size_t& in_flight = 8);
+
+    /**
+    * @brief Retrieves the next Player in the stream.
+    *
+    * @details If the current batch has players that have not been read yet,
+    * returns the next one. Otherwise waits for the oldest outstanding request,
+    * issues the request for the next window in its place, and returns the first
+    * Player of the received batch.
+    *
+    * @post If a new batch is received, `cursor_` is
+    *   set to the updated cursor value returned by the API call.
+    *
+    * @return The next Player object in the sequence.
+    * @throws std::runtime_error If there are no more players remaining or if the API request fails.
+    */
+    Player nextPlayer() override;
+
+    /**
+     * @brief Returns the number of players remaining in the stream.
+     *
+     * @return The count of players left to be read.
+     * @example If our stream is initialized with expected length 5,
+     *   after calling nextPlayer() twice, we'll have 3 players remaining.
+     */
+    size_t remaining() const override;
+
+    /**
+     * @brief Retrieves up to `capacity` of the next Players, receiving batches as needed.
+     *
+     * @param out A pointer to the first of `capacity` Players to assign into.
+     * @param capacity The maximum number of Players to retrieve.
+     * @return The number of Players assigned into `out`. 0 once the stream is exhausted.
+     * @throws std::runtime_error If an API request fails.
+     */
+    size_t nextBatch(Player* out, size_t capacity) override;
 };
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @brief Measures how rankConcurrent() scales with its producer count, against rankIncoming().
+ *
+ * Splits the same random players evenly between 1, 2, 4, ... producers up to the given
+ * maximum, each reading its share through a SpanPlayerStream, and ranks them for a small
+ * and a large reporting interval. rankIncoming() over all of the players is the serial
+ * baseline. Times are wall-clock and include fetching, which rankIncoming()'s elapsed_
+ * leaves out. Each configuration is timed over several fresh copies of the input and the
+ * fastest run is kept.
+ *
+ * Usage: ./concurrent_bench [players = 4000000] [max producers = 2 * hardware threads] [runs = 5]
+ */
+#include "Leaderboard.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Generates players with levels drawn uniformly from the sample server's [0, 1381).
+ */
+std::vector<Player> randomPlayers(size_t n) {
+    std::mt19937_64 rng(n);
+    std::uniform_int_distribution<size_t> level(0, 1380);
+    std::vector<Player> players;
+    players.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        players.emplace_back("Player" + std::to_string(i), level(rng));
+    }
+    return players;
+}
+
+/**
+ * @brief Ranks a fresh copy of `players` split between `producers` streams (0 for rankIncoming()).
+ * @return The wall-clock time (ms) of the ranking alone.
+ */
+double timeRanking(const std::vector<Player>& players, size_t producers, size_t interval) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<Player> copy = players;
+    if (producers == 0) {
+        SpanPlayerStream stream(copy);
+        Clock::time_point start = Clock::now();
+        Online::rankIncoming(stream, interval);
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::vector<SpanPlayerStream> streams;
+    streams.reserve(producers);
+    for (size_t p = 0; p < producers; p++) {
+        Player* first = copy.data() + p * copy.size() / producers;
+        Player* last = copy.data() + (p + 1) * copy.size() / producers;
+        streams.emplace_back(first, last);
+    }
+    std::vector<PlayerStream*> pointers;
+    for (SpanPlayerStream& stream : streams) {
+        pointers.push_back(&stream);
+    }
+    Clock::time_point start = Clock::now();
+    Online::rankConcurrent(pointers, interval);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const size_t max_producers = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                                          : 2 * std::max(1u, std::thread::hardware_concurrency());
+    const int runs = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    const std::vector<Player> players = randomPlayers(n);
+    std::printf("%zu players, %u hardware threads, best of %d runs\n", n, std::thread::hardware_concurrency(), runs);
+    std::printf("%10s %10s %12s %10s\n", "interval", "producers", "total (ms)", "speedup");
+
+    for (size_t interval : {size_t(1000), n / 40}) {
+        double baseline = 1e300;
+        for (int run = 0; run < runs; run++) {
+            baseline = std::min(baseline, timeRanking(players, 0, interval));
+        }
+        std::printf("%10zu %10s %12.2f %9.2fx\n", interval, "serial", baseline, 1.0);
+
+        for (size_t producers = 1; producers <= max_producers; producers *= 2) {
+            double best = 1e300;
+            for (int run = 0; run < runs; run++) {
+                best = std::min(best, timeRanking(players, producers, interval));
+            }
+            std::printf("%10zu %10zu %12.2f %9.2fx\n", interval, producers, best, baseline / best);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @brief Measures KllSketch's memory against its accuracy as epsilon varies.
+ *
+ * Inserts the same random levels into sketches of decreasing epsilon, each under several
+ * seeds, and reports the levels retained (and their bytes), the time per insert, and the
+ * rank error of quantile() queries at every 1% of the ranks, as a fraction of N. The
+ * exact alternative, rankIncoming() keeping the top players, holds reporting_interval
+ * Players instead.
+ *
+ * Usage: ./kll_bench [levels = 2000000] [seeds = 5]
+ */
+#include "Leaderboard.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Gets how far `level` is from having rank `rank` among the sorted levels.
+ *
+ * @return size_t 0 if some copy of `level` has that rank, else the distance to the nearest one.
+ */
+size_t rankError(const std::vector<size_t>& sorted, size_t level, size_t rank) {
+    size_t first = std::lower_bound(sorted.begin(), sorted.end(), level) - sorted.begin();
+    size_t last = std::upper_bound(sorted.begin(), sorted.end(), level) - sorted.begin();
+    if (rank < first) return first - rank;
+    if (rank >= last) return rank - last + 1;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const size_t seeds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+
+    std::mt19937_64 rng(n);
+    std::uniform_int_distribution<size_t> pick(0, 1000000000);
+    std::vector<size_t> levels(n);
+    for (size_t& level : levels) {
+        level = pick(rng);
+    }
+    std::vector<size_t> sorted = levels;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::printf("%zu levels, %zu seeds; rank errors are fractions of N (mean / worst over seeds)\n", n, seeds);
+    std::printf("%8s %10s %10s %12s %12s %12s\n", "epsilon", "retained", "KB", "ns/insert", "mean error", "worst error");
+    for (double epsilon : {0.1, 0.05, 0.02, 0.01, 0.005, 0.002, 0.001}) {
+        size_t retained = 0;
+        double nanoseconds = 0;
+        double error_sum = 0;
+        double worst = 0;
+        size_t queries = 0;
+
+        for (size_t seed = 1; seed <= seeds; seed++) {
+            Online::KllSketch sketch(epsilon, seed);
+            auto start = std::chrono::steady_clock::now();
+            for (size_t level : levels) {
+                sketch.insert(level);
+            }
+            nanoseconds += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            retained = std::max(retained, sketch.retained());
+
+            for (size_t percent = 0; percent <= 100; percent++) {
+                size_t rank = std::min(n - 1, n * percent / 100);
+                double error = static_cast<double>(rankError(sorted, sketch.quantile(rank), rank)) / n;
+                error_sum += error;
+                worst = std::max(worst, error);
+                queries++;
+            }
+        }
+
+        std::printf("%8.3f %10zu %10zu %12.1f %12.5f %12.5f\n", epsilon, retained, retained * sizeof(size_t) / 1024,
+                    nanoseconds / (seeds * n), error_sum / queries, worst);
+    }
+    std::printf("For comparison, exact rankIncoming() with a reporting interval of N / 10 holds %zu Players (%zu KB)\n",
+                n / 10, n / 10 * sizeof(Player) / 1024);
+    return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @brief Measures how parallelRank() scales with its thread count.
+ *
+ * Ranks the same random players with 1, 2, 4, ... threads up to the given maximum
+ * (1 thread runs quickSelectRank(), the sequential baseline parallelRank() defers to).
+ * Each count is timed over several fresh copies of the input and the fastest run is kept.
+ *
+ * Usage: ./parallel_bench [players = 5000000] [max threads = 2 * hardware threads] [runs = 5]
+ */
+#include "Leaderboard.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Generates players with levels drawn uniformly from the sample server's [0, 1381).
+ */
+std::vector<Player> randomPlayers(size_t n) {
+    std::mt19937_64 rng(n);
+    std::uniform_int_distribution<size_t> level(0, 1380);
+    std::vector<Player> players;
+    players.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        players.emplace_back("Player" + std::to_string(i), level(rng));
+    }
+    return players;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    const size_t max_threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                                        : 2 * std::max(1u, std::thread::hardware_concurrency());
+    const int runs = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    const std::vector<Player> players = randomPlayers(n);
+    std::printf("%zu players, %u hardware threads, best of %d runs\n", n, std::thread::hardware_concurrency(), runs);
+    std::printf("%8s %12s %12s %10s\n", "threads", "total (ms)", "select (ms)", "speedup");
+
+    double baseline = 0;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double best = 1e300;
+        double best_select = 0;
+        for (int run = 0; run < runs; run++) {
+            std::vector<Player> copy = players;
+            RankingResult result = Offline::parallelRank(copy, 0.1, threads);
+            double total = result.elapsed_;
+            if (total < best) {
+                best = total;
+                best_select = result.phases_.select_;
+            }
+        }
+        if (threads == 1) baseline = best;
+        std::printf("%8zu %12.2f %12.2f %9.2fx\n", threads, best, best_select, baseline / best);
+    }
+    return 0;
+}
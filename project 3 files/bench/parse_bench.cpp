@@ -0,0 +1,120 @@
+/**
+ * @brief Measures APIPlayerStream's per-batch overhead.
+ *
+ * 1) Parsing: APIPlayerStream::parseBatch() against nlohmann::json::parse() (as the spec's
+ *    version of the stream used) on a typical 10-level response body.
+ * 2) Fetching from a local server: one blocking cpr::Get() and json::parse() per batch, as
+ *    in the spec, against APIPlayerStream with 1 and with 8 requests in flight on keep-alive
+ *    sessions. Start the server first, e.g. `./server/api_server` (it must be on port 5000).
+ *
+ * Usage: ./parse_bench [players = 20000]
+ */
+#include "PlayerStream.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef API_ENABLED
+#error "parse_bench needs cpr and API_ENABLED, which bench/CMakeLists.txt defines when linking it"
+#endif
+
+#if __has_include(<nlohmann/json.hpp>)
+#include <nlohmann/json.hpp>
+#define HAS_NLOHMANN_JSON
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t SEED = 7;
+const size_t BATCH_SIZE = 10;
+
+double nanosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+void benchParse() {
+    const std::string body = R"({"cursor":123457,"levels":[1012,843,17,1380,999,12,655,301,77,1200]})";
+    const size_t iterations = 1000000;
+    std::vector<size_t> levels;
+    size_t cursor = 0;
+    size_t checksum = 0;
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        APIPlayerStream::parseBatch(body, levels, cursor);
+        checksum += levels[i % BATCH_SIZE] + cursor;
+    }
+    std::printf("%-36s %10.0f ns/batch\n", "parseBatch()", nanosecondsSince(start) / iterations);
+
+#ifdef HAS_NLOHMANN_JSON
+    start = Clock::now();
+    for (size_t i = 0; i < iterations / 10; i++) {
+        nlohmann::json json = nlohmann::json::parse(body);
+        levels.clear();
+        for (const auto& level : json["levels"]) {
+            levels.push_back(level.get<size_t>());
+        }
+        checksum += levels[i % BATCH_SIZE] + json["cursor"].get<size_t>();
+    }
+    std::printf("%-36s %10.0f ns/batch\n", "nlohmann::json::parse()", nanosecondsSince(start) / (iterations / 10));
+#endif
+    std::printf("(checksum %zu)\n", checksum);
+}
+
+#ifdef HAS_NLOHMANN_JSON
+// The spec's APIPlayerStream: one blocking request per batch, parsed into a JSON document
+double benchBlockingGet(size_t n) {
+    auto start = Clock::now();
+    for (size_t cursor = 1; cursor <= n; cursor += BATCH_SIZE) {
+        cpr::Response response = cpr::Get(cpr::Url{"http://127.0.0.1:5000/api"},
+                                          cpr::Parameters{{"seed", std::to_string(SEED)},
+                                                          {"cursor", std::to_string(cursor)},
+                                                          {"batch", std::to_string(BATCH_SIZE)}});
+        if (response.status_code != 200) {
+            throw std::runtime_error("API request failed (" + std::to_string(response.status_code) + ")");
+        }
+        nlohmann::json json = nlohmann::json::parse(response.text);
+        if (json["levels"].size() != BATCH_SIZE) {
+            throw std::runtime_error("API returned a short batch");
+        }
+    }
+    return nanosecondsSince(start);
+}
+#endif
+
+double benchStream(size_t n, size_t in_flight) {
+    std::vector<Player> players(256);
+    auto start = Clock::now();
+    APIPlayerStream stream(n, SEED, BATCH_SIZE, in_flight);
+    while (stream.nextBatch(players.data(), players.size()) > 0) {
+    }
+    return nanosecondsSince(start);
+}
+
+void benchFetch(size_t n) {
+    const double batches = static_cast<double>(n / BATCH_SIZE);
+    std::printf("\n%zu players in batches of %zu from 127.0.0.1:5000\n", n, BATCH_SIZE);
+    try {
+#ifdef HAS_NLOHMANN_JSON
+        std::printf("%-36s %10.1f us/batch\n", "cpr::Get() + json::parse()", benchBlockingGet(n) / batches / 1000);
+#endif
+        std::printf("%-36s %10.1f us/batch\n", "APIPlayerStream, 1 in flight", benchStream(n, 1) / batches / 1000);
+        std::printf("%-36s %10.1f us/batch\n", "APIPlayerStream, 8 in flight", benchStream(n, 8) / batches / 1000);
+    } catch (const std::runtime_error& error) {
+        std::fprintf(stderr, "%s\nIs server/api_server running on port 5000?\n", error.what());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    benchParse();
+    benchFetch(n - n % BATCH_SIZE);
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @brief Compares heapRank() and quickSelectRank() against the rankers they replaced.
+ *
+ * The baselines are the original implementations: a heapRank that rebuilds its whole
+ * min-heap with std::make_heap whenever a player beats the root, and a quickSelectRank
+ * that pivots on the last player with two-way Lomuto partitioning. Both degrade to
+ * O(N * k) or O(N^2) on sorted input, so they are skipped above BASELINE_LIMIT players.
+ *
+ * Every ranker is timed on random (levels in [0, 1381), with many ties), sorted and
+ * reverse-sorted players, keeping the fastest of several runs on fresh copies.
+ *
+ * Usage: ./select_bench [players = 20000] [runs = 5]
+ */
+#include "Leaderboard.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t BASELINE_LIMIT = 50000;
+
+namespace Baseline {
+
+std::vector<Player> heapRank(std::vector<Player>& players) {
+    size_t top_count = std::floor(0.1 * players.size());
+    std::vector<Player> top;
+    if (top_count > 0) {
+        std::make_heap(players.begin(), players.begin() + top_count, std::greater<Player>());
+        for (size_t i = top_count; i < players.size(); i++) {
+            if (players[i] > players[0]) {
+                std::swap(players[0], players[i]);
+                std::make_heap(players.begin(), players.begin() + top_count, std::greater<Player>());
+            }
+        }
+        top.assign(players.begin(), players.begin() + top_count);
+        std::sort(top.begin(), top.end());
+    }
+    return top;
+}
+
+size_t partition(std::vector<Player>& players, size_t left, size_t right) {
+    Player pivot = players[right];
+    size_t i = left;
+    for (size_t j = left; j < right; j++) {
+        if (players[j] > pivot) {
+            std::swap(players[i], players[j]);
+            i++;
+        }
+    }
+    std::swap(players[i], players[right]);
+    return i;
+}
+
+std::vector<Player> quickSelectRank(std::vector<Player>& players) {
+    size_t top_count = std::floor(0.1 * players.size());
+    std::vector<Player> top;
+    if (top_count > 0) {
+        size_t left = 0;
+        size_t right = players.size() - 1;
+        while (left <= right) {
+            size_t pivot_idx = partition(players, left, right);
+            if (pivot_idx == top_count - 1) {
+                break;
+            } else if (pivot_idx < top_count - 1) {
+                left = pivot_idx + 1;
+            } else {
+                right = pivot_idx - 1;
+            }
+        }
+        top.assign(players.begin(), players.begin() + top_count);
+        std::sort(top.begin(), top.end());
+    }
+    return top;
+}
+
+} // namespace Baseline
+
+using Ranker = std::function<void(std::vector<Player>&)>;
+
+std::vector<Player> makePlayers(size_t n, const std::string& order) {
+    std::mt19937_64 rng(n);
+    std::uniform_int_distribution<size_t> level(0, 1380);
+    std::vector<Player> players;
+    players.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        size_t player_level = order == "random" ? level(rng) : order == "sorted" ? i : n - i;
+        players.emplace_back("Player" + std::to_string(i), player_level);
+    }
+    return players;
+}
+
+/**
+ * @brief Times a ranker on fresh copies of the players.
+ *
+ * @return double The fastest run, in milliseconds.
+ */
+double bestOf(int runs, const std::vector<Player>& players, const Ranker& rank) {
+    double best = 1e300;
+    for (int run = 0; run < runs; run++) {
+        std::vector<Player> copy = players;
+        auto start = std::chrono::steady_clock::now();
+        rank(copy);
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    const int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+    const bool baselines = n <= BASELINE_LIMIT;
+
+    const std::vector<std::pair<const char*, Ranker>> rankers = {
+        {"baseline heapRank", [](std::vector<Player>& p) { Baseline::heapRank(p); }},
+        {"heapRank arity 2", [](std::vector<Player>& p) { Offline::heapRank(p, 0.1, 2); }},
+        {"heapRank arity 4", [](std::vector<Player>& p) { Offline::heapRank(p, 0.1, 4); }},
+        {"heapRank arity 8", [](std::vector<Player>& p) { Offline::heapRank(p, 0.1, 8); }},
+        {"baseline quickSelectRank", [](std::vector<Player>& p) { Baseline::quickSelectRank(p); }},
+        {"quickSelectRank", [](std::vector<Player>& p) { Offline::quickSelectRank(p); }},
+    };
+    const char* orders[] = {"random", "sorted", "reverse"};
+
+    std::vector<std::vector<Player>> inputs;
+    for (const char* order : orders) {
+        inputs.push_back(makePlayers(n, order));
+    }
+
+    std::printf("%zu players, best of %d runs (ms)\n", n, runs);
+    std::printf("%-26s %12s %12s %12s\n", "", orders[0], orders[1], orders[2]);
+    for (const auto& [name, rank] : rankers) {
+        bool baseline = std::string(name).rfind("baseline", 0) == 0;
+        std::printf("%-26s", name);
+        for (const auto& players : inputs) {
+            if (baseline && !baselines) {
+                std::printf(" %12s", "-");
+            } else {
+                std::printf(" %12.2f", bestOf(runs, players, rank));
+            }
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+/**
+ * @brief Converts a player file to the binary format read by MmapPlayerStream.
+ *
+ * The input may be a CSV player file (one `name,level,id` line per player) or a
+ * binary one, which is simply rewritten. Players are converted one chunk at a
+ * time, so files of any size convert in constant memory.
+ *
+ * Usage: ./player_convert <input> <output>
+ */
+#include "PlayerFile.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const size_t CHUNK_SIZE = 1 << 14;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: %s <input> <output>\n", argv[0]);
+        return 2;
+    }
+
+    try {
+        PlayerFile::Reader reader(argv[1]);
+        PlayerFile::Writer writer(argv[2]);
+        std::vector<Player> chunk(CHUNK_SIZE);
+        size_t truncated = 0;
+
+        while (size_t read = reader.read(chunk.data(), chunk.size())) {
+            for (size_t i = 0; i < read; i++) {
+                truncated += chunk[i].name_.size() > PlayerFile::NAME_WIDTH;
+                writer.write(chunk[i]);
+            }
+        }
+        writer.close();
+
+        std::printf("Wrote %zu players to %s\n", writer.count(), argv[2]);
+        if (truncated > 0) {
+            std::fprintf(stderr, "Truncated %zu names to %zu bytes\n", truncated, PlayerFile::NAME_WIDTH);
+        }
+    } catch (const std::runtime_error& error) {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+    return 0;
+}
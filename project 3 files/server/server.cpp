@@ -0,0 +1,346 @@
+/**
+ * @brief A native stand-in for server.py, for load-testing PlayerStreams.
+ *
+ * Serves the same endpoint with the same levels, validation & JSON shape:
+ *   GET /api?seed={SEED}&cursor={CURSOR}&batch={BATCH}  (batch <= BATCH_CUTOFF)
+ *   -> {"cursor":CURSOR+BATCH,"levels":[...]}
+ *
+ * plus a bulk endpoint with the same parameters & response, whose batches may be
+ * up to BULK_CUTOFF levels:
+ *   GET /api/bulk?seed={SEED}&cursor={CURSOR}&batch={BATCH}
+ *
+ * One thread multiplexes every connection with epoll. Connections are HTTP/1.1
+ * keep-alive (pipelined requests are answered in order) and nothing is logged.
+ *
+ * Usage: ./api_server [port]  (defaults to 5000)
+ */
+#include <arpa/inet.h>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+const long long PRIME_WRAPPER = 1381;
+const long long BATCH_CUTOFF = 10;
+const long long BULK_CUTOFF = 1 << 20;
+
+// Requests larger than this without a blank line are rejected
+const size_t MAX_HEADER_SIZE = 16 * 1024;
+
+// The epoll events a connection waits for while reading, and while its output is backed up
+const uint32_t READ_EVENTS = EPOLLIN | EPOLLRDHUP;
+const uint32_t WRITE_EVENTS = EPOLLOUT;
+
+/**
+ * @brief Matches server.py's get_pseudorandom(seed, cursor) = seed * cursor * 3 % 1381,
+ * reducing each factor first so large (positive) arguments can't overflow.
+ */
+long long getPseudorandom(long long seed, long long cursor) {
+    return (seed % PRIME_WRAPPER) * (cursor % PRIME_WRAPPER) % PRIME_WRAPPER * 3 % PRIME_WRAPPER;
+}
+
+/**
+ * @brief Appends a level in [0, PRIME_WRAPPER) in decimal, without going through printf.
+ */
+void appendLevel(std::string& body, long long level) {
+    char digits[4];
+    int length = 0;
+    do {
+        digits[length++] = '0' + level % 10;
+        level /= 10;
+    } while (level > 0);
+    while (length > 0) body += digits[--length];
+}
+
+/**
+ * @brief Per-connection state: unparsed request bytes & unsent response bytes.
+ */
+struct Connection {
+    std::string in_;
+    std::string out_;
+    size_t sent_ = 0;
+    bool close_after_write_ = false;
+    bool peer_closed_ = false;       // The client has shut down its side; finish writing, then close
+    uint32_t events_ = READ_EVENTS; // The epoll events currently registered
+};
+
+/**
+ * @brief Looks up an integer query parameter, as Flask's request.args.get(name, type=int) would.
+ * @return The value, or std::nullopt if it is missing or not an integer.
+ */
+std::optional<long long> queryInt(std::string_view query, std::string_view name) {
+    while (!query.empty()) {
+        size_t amp = query.find('&');
+        std::string_view pair = query.substr(0, amp);
+        query = amp == std::string_view::npos ? std::string_view() : query.substr(amp + 1);
+
+        size_t eq = pair.find('=');
+        if (eq == std::string_view::npos || pair.substr(0, eq) != name) continue;
+
+        std::string value(pair.substr(eq + 1));
+        if (value.empty()) return std::nullopt;
+        char* end;
+        errno = 0;
+        long long parsed = std::strtoll(value.c_str(), &end, 10);
+        if (*end != '\0' || errno == ERANGE) return std::nullopt;
+        return parsed;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Appends a complete HTTP/1.1 response to the connection's output.
+ */
+void respond(Connection& connection, int status, std::string_view content_type, std::string_view body) {
+    const char* reason = status == 200 ? "OK" : status == 400 ? "BAD REQUEST" : "NOT FOUND";
+    char header[256];
+    int length = std::snprintf(header, sizeof(header),
+        "HTTP/1.1 %d %s\r\nContent-Type: %.*s\r\nContent-Length: %zu\r\n%s\r\n",
+        status, reason, static_cast<int>(content_type.size()), content_type.data(), body.size(),
+        connection.close_after_write_ ? "Connection: close\r\n" : "");
+    connection.out_.append(header, length);
+    connection.out_.append(body);
+}
+
+void respondError(Connection& connection, int status, const std::string& message) {
+    respond(connection, status, "text/html; charset=utf-8", message);
+}
+
+/**
+ * @brief Answers one GET for /api or /api/bulk, validating the parameters in the
+ * same order (and with the same messages) as server.py.
+ */
+void serveLevels(Connection& connection, std::string_view query, long long cutoff) {
+    std::optional<long long> seed = queryInt(query, "seed");
+    std::optional<long long> cursor = queryInt(query, "cursor");
+    long long batch = queryInt(query, "batch").value_or(1);
+
+    auto show = [](const std::optional<long long>& value) {
+        return value ? std::to_string(*value) : std::string("None");
+    };
+    if (!seed || !cursor || *cursor == 0) {
+        return respondError(connection, 400, "Invalid request data, received seed=" + show(seed) + ", cursor=" + show(cursor));
+    }
+    if (batch > cutoff) {
+        return respondError(connection, 400, "Your batch size is too big: " + std::to_string(batch));
+    }
+    if (batch <= 0) {
+        return respondError(connection, 400, "Your batch size is too low:  " + std::to_string(batch));
+    }
+    if (*cursor < 0) {
+        return respondError(connection, 400, "Your cursor is too low: " + std::to_string(*cursor));
+    }
+    if (*seed < 1) {
+        return respondError(connection, 400, "Your seed is too low: " + std::to_string(*seed));
+    }
+
+    // Each level is at most 4 digits & a comma
+    std::string body;
+    body.reserve(48 + 5 * batch);
+    body += "{\"cursor\":";
+    body += std::to_string(*cursor + batch);
+    body += ",\"levels\":[";
+
+    // Step the level incrementally: seed * (cursor + 1) * 3 = seed * cursor * 3 + seed * 3
+    long long level = getPseudorandom(*seed, *cursor);
+    long long step = getPseudorandom(*seed, 1);
+    for (long long i = 0; i < batch; i++) {
+        if (i) body += ',';
+        appendLevel(body, level);
+        level += step;
+        if (level >= PRIME_WRAPPER) level -= PRIME_WRAPPER;
+    }
+    body += "]}\n";
+
+    respond(connection, 200, "application/json", body);
+}
+
+/**
+ * @brief Parses & answers every complete request buffered on a connection.
+ * @return False if the connection sent something unparseable and should be dropped.
+ */
+bool serveRequests(Connection& connection) {
+    size_t consumed = 0;
+    while (!connection.close_after_write_) {
+        size_t header_end = connection.in_.find("\r\n\r\n", consumed);
+        if (header_end == std::string::npos) {
+            if (connection.in_.size() - consumed > MAX_HEADER_SIZE) return false;
+            break;
+        }
+        std::string_view request(connection.in_.data() + consumed, header_end - consumed);
+        consumed = header_end + 4;
+
+        // Request line: METHOD TARGET VERSION
+        size_t line_end = request.find("\r\n");
+        std::string_view line = request.substr(0, line_end);
+        size_t first_space = line.find(' ');
+        size_t second_space = line.find(' ', first_space + 1);
+        if (first_space == std::string_view::npos || second_space == std::string_view::npos) return false;
+        std::string_view method = line.substr(0, first_space);
+        std::string_view target = line.substr(first_space + 1, second_space - first_space - 1);
+        std::string_view version = line.substr(second_space + 1);
+
+        // HTTP/1.1 defaults to keep-alive, HTTP/1.0 to close
+        std::string headers(request.substr(line_end == std::string_view::npos ? request.size() : line_end));
+        for (char& c : headers) c = std::tolower(static_cast<unsigned char>(c));
+        bool keep_alive = version == "HTTP/1.1"
+            ? headers.find("\r\nconnection: close") == std::string::npos
+            : headers.find("\r\nconnection: keep-alive") != std::string::npos;
+        connection.close_after_write_ = !keep_alive;
+
+        size_t question = target.find('?');
+        std::string_view path = target.substr(0, question);
+        std::string_view query = question == std::string_view::npos ? std::string_view() : target.substr(question + 1);
+
+        if (method != "GET") {
+            respondError(connection, 404, "You're querying the wrong endpoint: " + std::string(path) + ". On the bright side, you're connected!");
+        } else if (path == "/api") {
+            serveLevels(connection, query, BATCH_CUTOFF);
+        } else if (path == "/api/bulk") {
+            serveLevels(connection, query, BULK_CUTOFF);
+        } else {
+            respondError(connection, 404, "You're querying the wrong endpoint: " + std::string(path) + ". On the bright side, you're connected!");
+        }
+    }
+    connection.in_.erase(0, consumed);
+    return true;
+}
+
+/**
+ * @brief Writes as much pending output as the socket accepts.
+ * @return False if the connection failed or is finished and should be closed.
+ */
+bool flush(int fd, Connection& connection) {
+    while (connection.sent_ < connection.out_.size()) {
+        ssize_t written = send(fd, connection.out_.data() + connection.sent_,
+                               connection.out_.size() - connection.sent_, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        connection.sent_ += written;
+    }
+    connection.out_.clear();
+    connection.sent_ = 0;
+    return !connection.close_after_write_;
+}
+
+void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int port = argc > 1 ? std::atoi(argv[1]) : 5000;
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, SOMAXCONN) < 0) {
+        std::perror("api_server: bind/listen");
+        return 1;
+    }
+    setNonBlocking(listener);
+
+    int epoll = epoll_create1(0);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+
+    std::printf(" * Serving on http://0.0.0.0:%d (/api, /api/bulk)\n", port);
+    std::fflush(stdout);
+
+    std::unordered_map<int, Connection> connections;
+    auto closeConnection = [&](int fd) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    };
+
+    const int MAX_EVENTS = 256;
+    epoll_event events[MAX_EVENTS];
+    char buffer[64 * 1024];
+
+    while (true) {
+        int ready = epoll_wait(epoll, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::perror("api_server: epoll_wait");
+            return 1;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+
+            if (fd == listener) {
+                int client;
+                while ((client = accept(listener, nullptr, nullptr)) >= 0) {
+                    setNonBlocking(client);
+                    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                    epoll_event client_event{};
+                    client_event.events = READ_EVENTS;
+                    client_event.data.fd = client;
+                    epoll_ctl(epoll, EPOLL_CTL_ADD, client, &client_event);
+                    connections[client];
+                }
+                continue;
+            }
+
+            Connection& connection = connections[fd];
+            bool open = true;
+
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                ssize_t received;
+                while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+                    connection.in_.append(buffer, received);
+                }
+                if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    connection.peer_closed_ = true;
+                }
+                open = serveRequests(connection);
+            }
+            if (open && !connection.out_.empty()) {
+                open = flush(fd, connection);
+            }
+            if (!open || (connection.peer_closed_ && connection.out_.empty())) {
+                closeConnection(fd);
+                continue;
+            }
+
+            // Only wait for writability while output is backed up. Once the peer has closed, stop
+            // waiting to read too: EPOLLIN & EPOLLRDHUP stay ready at EOF and would wake us forever.
+            uint32_t wanted = (connection.peer_closed_ ? 0 : READ_EVENTS) | (connection.out_.empty() ? 0 : WRITE_EVENTS);
+            if (wanted != connection.events_) {
+                epoll_event client_event{};
+                client_event.events = wanted;
+                client_event.data.fd = fd;
+                epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &client_event);
+                connection.events_ = wanted;
+            }
+        }
+    }
+}
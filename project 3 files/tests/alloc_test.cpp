@@ -0,0 +1,137 @@
+/**
+ * @brief Checks that the rankers allocate a bounded number of times, however many players
+ *        they rank: they move Players (and so their names) around rather than copying them.
+ *
+ * Replaces the global operator new to count every heap allocation. Every player's name is
+ * too long for the small-string buffer, so a single copied Player costs an allocation.
+ *
+ * rankIncoming() ranks the same players through a VectorPlayerStream built from a const&
+ * (which copies every Player) and through a SpanPlayerStream over them (which moves them
+ * out). The offline rankers rank a vector in place. At two input sizes, everything but the
+ * copying stream must stay within ALLOCATION_LIMIT allocations, plus one per cutoff recorded
+ * (each is a node of the result's map).
+ */
+#include "Leaderboard.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t REPORTING_INTERVAL = 1000;
+
+// Fixed costs: result vectors, stream batch buffers, histograms, threads & their bookkeeping
+const size_t ALLOCATION_LIMIT = 256;
+
+size_t allocations = 0;
+bool counting = false;
+
+bool check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+    }
+    return condition;
+}
+
+std::vector<size_t> levels(const RankingResult& result) {
+    std::vector<size_t> out;
+    for (const Player& player : result.top_) {
+        out.push_back(player.level_);
+    }
+    return out;
+}
+
+/**
+ * @brief Ranks a stream with rankIncoming(), counting the allocations made from
+ *        constructing the stream to destroying it.
+ */
+template <typename Stream, typename Source>
+RankingResult rankCounted(Source&& source, size_t& count) {
+    allocations = 0;
+    counting = true;
+    RankingResult result = [&] {
+        Stream stream(std::forward<Source>(source));
+        return Online::rankIncoming(stream, REPORTING_INTERVAL);
+    }();
+    counting = false;
+    count = allocations;
+    return result;
+}
+
+/**
+ * @brief Ranks a copy of `players` with an offline ranker, counting the allocations made by the ranker alone.
+ */
+RankingResult rankCounted(const std::function<RankingResult(std::vector<Player>&)>& rank,
+                          const std::vector<Player>& players, size_t& count) {
+    std::vector<Player> copy = players;
+    allocations = 0;
+    counting = true;
+    RankingResult result = rank(copy);
+    counting = false;
+    count = allocations;
+    return result;
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (counting) allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+int main() {
+    const std::pair<const char*, std::function<RankingResult(std::vector<Player>&)>> rankers[] = {
+        {"heapRank", [](std::vector<Player>& p) { return Offline::heapRank(p); }},
+        {"quickSelectRank", [](std::vector<Player>& p) { return Offline::quickSelectRank(p); }},
+        {"countingRank", [](std::vector<Player>& p) { return Offline::countingRank(p); }},
+        {"parallelRank", [](std::vector<Player>& p) { return Offline::parallelRank(p, 0.1, 2); }},
+    };
+
+    bool ok = true;
+    for (size_t n : {100000, 400000}) {
+        std::vector<Player> players;
+        players.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            players.emplace_back("a_long_player_name_" + std::to_string(i), (i * 7919) % 1381);
+        }
+        const std::vector<Player> original = players;
+        std::printf("n = %zu\n", n);
+
+        size_t copied_allocations = 0;
+        size_t span_allocations = 0;
+        RankingResult copied = rankCounted<VectorPlayerStream>(original, copied_allocations);
+        RankingResult spanned = rankCounted<SpanPlayerStream>(players, span_allocations);
+        std::printf("  rankIncoming, VectorPlayerStream (copy): %zu allocations\n", copied_allocations);
+        std::printf("  rankIncoming, SpanPlayerStream:          %zu allocations\n", span_allocations);
+
+        ok &= check(levels(copied) == levels(spanned), "both streams rank the same levels");
+        ok &= check(copied.top_.size() == REPORTING_INTERVAL, "the top <reporting_interval> players are kept");
+        ok &= check(copied_allocations >= n, "copying the stream allocates per player");
+        ok &= check(span_allocations <= n / REPORTING_INTERVAL + ALLOCATION_LIMIT,
+                    "the span stream allocates once per cutoff, plus a bounded number of times");
+
+        std::vector<size_t> expected;
+        for (const auto& [name, rank] : rankers) {
+            size_t count = 0;
+            RankingResult result = rankCounted(rank, original, count);
+            std::printf("  %-16s %zu allocations\n", name, count);
+            if (expected.empty()) expected = levels(result);
+
+            ok &= check(result.top_.size() == n / 10 && levels(result) == expected, "the rankers agree");
+            ok &= check(count <= ALLOCATION_LIMIT, "the offline rankers allocate a bounded number of times");
+        }
+    }
+    return ok ? 0 : 1;
+}
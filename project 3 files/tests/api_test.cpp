@@ -0,0 +1,190 @@
+/**
+ * @brief Checks APIPlayerStream against server/api_server.
+ *
+ * Starts the server on port 5000 (where APIPlayerStream connects), then reads players
+ * through nextBatch(), nextPlayer() and rankIncoming(), comparing every level with the
+ * server's formula, seed * cursor * 3 % 1381. A batch over the server's cap must throw.
+ *
+ * Usage: ./api_test <path to api_server>
+ */
+#include "Leaderboard.hpp"
+#include "PlayerStream.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifndef API_ENABLED
+#error "api_test needs cpr and API_ENABLED, which tests/CMakeLists.txt defines when linking it"
+#endif
+
+namespace {
+
+const char* PORT = "5000";
+const size_t SEED = 7;
+
+bool check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+    }
+    return condition;
+}
+
+size_t expectedLevel(size_t cursor) {
+    return SEED * cursor * 3 % 1381;
+}
+
+bool serverAccepts() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(std::stoi(PORT));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bool connected = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    close(fd);
+    return connected;
+}
+
+/**
+ * @brief Runs the server in a child process and waits until it accepts connections.
+ *
+ * @return pid_t The child's pid.
+ * @throws std::runtime_error If the port is taken, or the server exits or is not up within 5 seconds.
+ */
+pid_t startServer(const char* path) {
+    if (serverAccepts()) {
+        throw std::runtime_error("Port " + std::string(PORT) + " is already in use");
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        execl(path, path, PORT, static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    if (pid < 0) {
+        throw std::runtime_error("Cannot fork the server");
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!serverAccepts()) {
+        int status;
+        if (waitpid(pid, &status, WNOHANG) == pid) {
+            throw std::runtime_error(std::string("The server exited early: ") + path);
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+            kill(pid, SIGTERM);
+            waitpid(pid, nullptr, 0);
+            throw std::runtime_error("The server did not start listening on port " + std::string(PORT));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return pid;
+}
+
+bool testNextBatch() {
+    const size_t n = 1000;
+    APIPlayerStream stream(n, SEED, 10, 4);
+    std::vector<Player> players(64);
+    size_t cursor = 1;
+    bool ok = true;
+    while (size_t read = stream.nextBatch(players.data(), players.size())) {
+        for (size_t i = 0; i < read; i++, cursor++) {
+            ok &= check(players[i].level_ == expectedLevel(cursor) && players[i].id_ == cursor
+                        && players[i].name_ == "API_" + std::to_string(cursor),
+                        "nextBatch() player " + std::to_string(cursor));
+        }
+    }
+    ok &= check(cursor == n + 1, "nextBatch() reads every player");
+    ok &= check(stream.remaining() == 0, "nextBatch() exhausts the stream");
+    return ok;
+}
+
+bool testNextPlayer() {
+    const size_t n = 50;
+    APIPlayerStream stream(n, SEED, 5, 1);
+    bool ok = true;
+    for (size_t cursor = 1; cursor <= n; cursor++) {
+        ok &= check(stream.remaining() == n - cursor + 1, "remaining() before player " + std::to_string(cursor));
+        Player player = stream.nextPlayer();
+        ok &= check(player.level_ == expectedLevel(cursor), "nextPlayer() player " + std::to_string(cursor));
+    }
+    bool threw = false;
+    try {
+        stream.nextPlayer();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    return ok & check(threw, "nextPlayer() throws once the stream is exhausted");
+}
+
+bool testRankIncoming() {
+    const size_t n = 2000;
+    const size_t interval = 100;
+    std::vector<Player> expected;
+    for (size_t cursor = 1; cursor <= n; cursor++) {
+        expected.emplace_back("API_" + std::to_string(cursor), expectedLevel(cursor), cursor);
+    }
+    VectorPlayerStream local(std::move(expected));
+    APIPlayerStream remote(n, SEED, 10);
+    RankingResult want = Online::rankIncoming(local, interval);
+    RankingResult got = Online::rankIncoming(remote, interval);
+
+    bool ok = check(got.cutoffs_ == want.cutoffs_, "rankIncoming() cutoffs match a local stream");
+    ok &= check(got.top_.size() == want.top_.size(), "rankIncoming() keeps the top players");
+    for (size_t i = 0; ok && i < got.top_.size(); i++) {
+        ok &= check(got.top_[i].level_ == want.top_[i].level_, "rankIncoming() top player " + std::to_string(i));
+    }
+    return ok;
+}
+
+bool testOversizedBatch() {
+    bool threw = false;
+    try {
+        APIPlayerStream stream(20, SEED, 11);
+        stream.nextPlayer();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    return check(threw, "a batch over the server's cap of 10 throws");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: %s <path to api_server>\n", argv[0]);
+        return 2;
+    }
+
+    pid_t server;
+    try {
+        server = startServer(argv[1]);
+    } catch (const std::runtime_error& error) {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+
+    bool ok = true;
+    try {
+        ok &= testNextBatch();
+        ok &= testNextPlayer();
+        ok &= testRankIncoming();
+        ok &= testOversizedBatch();
+    } catch (const std::runtime_error& error) {
+        ok = check(false, error.what());
+    }
+
+    kill(server, SIGTERM);
+    waitpid(server, nullptr, 0);
+    return ok ? 0 : 1;
+}
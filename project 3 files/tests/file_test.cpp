@@ -0,0 +1,319 @@
+/**
+ * @brief Checks the player files: Writer to Reader round trips, MmapPlayerStream and
+ *        CsvPlayerStream against the players written, and player_convert.
+ *
+ * CSV files are written with and without a byte order mark, header line, leading and
+ * interior blank lines, "\r\n" endings and a final line ending, and are read through
+ * buffers small enough that lines straddle (and outgrow) them. remaining() is asked for
+ * throughout reading or only at its end, since a CSV file is counted lazily.
+ *
+ * Usage: ./file_test [path to player_convert]; without it, player_convert isn't tested.
+ */
+#include "PlayerFile.hpp"
+#include "PlayerStream.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::string BINARY_PATH = "file_test.bin";
+const std::string CSV_PATH = "file_test.csv";
+const std::string CONVERTED_PATH = "file_test_converted.bin";
+const size_t SIZES[] = {0, 1, 2, 1000, 54321};
+
+bool check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+    }
+    return condition;
+}
+
+/**
+ * @brief Generates `n` players with names of 1 to 2 * NAME_WIDTH bytes, some with commas.
+ */
+std::vector<Player> makePlayers(size_t n, std::mt19937_64& random) {
+    std::vector<Player> players;
+    players.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        std::string name = "p" + std::to_string(i) + (i % 5 == 0 ? ",with,commas" : "");
+        name.resize(std::max(name.size(), size_t(random() % (2 * PlayerFile::NAME_WIDTH))), 'x');
+        players.emplace_back(name, random() % 1381, random());
+    }
+    return players;
+}
+
+/**
+ * @brief The players as a binary file stores them, with names cut to NAME_WIDTH bytes.
+ */
+std::vector<Player> truncated(std::vector<Player> players) {
+    for (Player& player : players) {
+        if (player.name_.size() > PlayerFile::NAME_WIDTH) player.name_.resize(PlayerFile::NAME_WIDTH);
+    }
+    return players;
+}
+
+/**
+ * @brief Compares names, levels & ids, where Player::operator== compares levels alone.
+ */
+bool same(const std::vector<Player>& a, const std::vector<Player>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Player& x, const Player& y) {
+        return x.name_ == y.name_ && x.level_ == y.level_ && x.id_ == y.id_;
+    });
+}
+
+void writeBinary(const std::string& path, const std::vector<Player>& players) {
+    PlayerFile::Writer writer(path);
+    for (const Player& player : players) writer.write(player);
+    writer.close();
+}
+
+/**
+ * @brief How a CSV file is laid out around its players.
+ */
+struct CsvLayout {
+    bool byte_order_mark;
+    bool header;
+    const char* leading; // Blank lines before the header (or first player)
+    const char* line_end;
+    bool final_line_end;
+    bool interior_blanks; // A blank line after every 100th player
+};
+
+const CsvLayout LAYOUTS[] = {
+    {false, false, "", "\n", true, false},
+    {false, true, "", "\n", false, false},
+    {true, true, "", "\r\n", true, false},
+    {true, false, "", "\n", true, true},
+    {false, true, "\n\r\n", "\r\n", false, true},
+    {true, true, "\n\n", "\n", true, true},
+};
+
+void writeCsv(const std::string& path, const std::vector<Player>& players, const CsvLayout& layout) {
+    std::ofstream out(path, std::ios::binary);
+    if (layout.byte_order_mark) out << "\xEF\xBB\xBF";
+    out << layout.leading;
+    if (layout.header) out << "name,level,id" << layout.line_end;
+    for (size_t i = 0; i < players.size(); i++) {
+        out << players[i].name_ << ',' << players[i].level_ << ',' << players[i].id_;
+        if (i + 1 < players.size() || layout.final_line_end) out << layout.line_end;
+        if (layout.interior_blanks && i % 100 == 99) out << layout.line_end;
+    }
+}
+
+/**
+ * @brief Drains a stream. If `ask_remaining` is set, reads alternately by nextPlayer() and
+ *        nextBatch() while remaining() is above 0, checking it before every call; otherwise
+ *        reads by nextBatch() until it returns 0, leaving remaining() until the end.
+ */
+std::vector<Player> drain(PlayerStream& stream, size_t batch_size, bool ask_remaining, bool& ok) {
+    std::vector<Player> out;
+    std::vector<Player> batch(batch_size);
+    if (ask_remaining) {
+        size_t expected_remaining = stream.remaining();
+        for (bool single = true; stream.remaining() > 0; single = !single) {
+            ok &= check(stream.remaining() == expected_remaining, "remaining() counts down as players are read");
+            size_t got = 1;
+            if (single) {
+                out.push_back(stream.nextPlayer());
+            } else {
+                got = stream.nextBatch(batch.data(), batch.size());
+                out.insert(out.end(), batch.begin(), batch.begin() + got);
+            }
+            expected_remaining -= got;
+        }
+    } else {
+        while (size_t got = stream.nextBatch(batch.data(), batch.size())) {
+            out.insert(out.end(), batch.begin(), batch.begin() + got);
+        }
+    }
+    ok &= check(stream.remaining() == 0, "remaining() is 0 once the stream is exhausted");
+
+    bool threw = false;
+    try {
+        stream.nextPlayer();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ok &= check(threw, "nextPlayer() throws once the stream is exhausted");
+    return out;
+}
+
+/**
+ * @brief Reads a whole file through a Reader in chunks of `chunk_size` players.
+ */
+std::vector<Player> readAll(PlayerFile::Reader& reader, size_t chunk_size) {
+    std::vector<Player> out;
+    std::vector<Player> chunk(chunk_size);
+    while (size_t got = reader.read(chunk.data(), chunk.size())) {
+        out.insert(out.end(), chunk.begin(), chunk.begin() + got);
+    }
+    return out;
+}
+
+bool testRoundTrip() {
+    bool ok = true;
+    std::mt19937_64 random(49);
+    for (size_t n : SIZES) {
+        const std::vector<Player> players = makePlayers(n, random);
+        PlayerFile::Writer writer(BINARY_PATH);
+        for (const Player& player : players) writer.write(player);
+        writer.close();
+        writer.close();
+        ok &= check(writer.count() == n, "the Writer counts the players written");
+
+        for (size_t buffer_size : {size_t(1), size_t(1000), PlayerFile::READ_BUFFER_SIZE}) {
+            for (size_t chunk_size : {size_t(1), size_t(7), size_t(4096)}) {
+                PlayerFile::Reader reader(BINARY_PATH, buffer_size);
+                ok &= check(reader.binary(), "a written file reads as binary");
+                ok &= check(reader.count() == n && reader.remaining() == n, "the header holds the count");
+                ok &= check(same(readAll(reader, chunk_size), truncated(players)),
+                            "players read back as written, names cut to NAME_WIDTH");
+                ok &= check(reader.remaining() == 0, "nothing remains once read");
+            }
+        }
+    }
+
+    // Until close() patches the header's count, the file reads as empty
+    {
+        PlayerFile::Writer writer(BINARY_PATH);
+        writer.write(Player("unclosed", 1, 2));
+        PlayerFile::Reader reader(BINARY_PATH);
+        ok &= check(reader.count() == 0, "an unclosed file reads as empty");
+    }
+    return ok;
+}
+
+bool testMmapPlayerStream() {
+    bool ok = true;
+    std::mt19937_64 random(50);
+    for (size_t n : SIZES) {
+        const std::vector<Player> players = makePlayers(n, random);
+        writeBinary(BINARY_PATH, players);
+        for (size_t batch_size : {size_t(1), size_t(64), size_t(100000)}) {
+            for (bool ask_remaining : {false, true}) {
+                MmapPlayerStream stream(BINARY_PATH);
+                ok &= check(stream.remaining() == n, "MmapPlayerStream knows its count");
+                ok &= check(same(drain(stream, batch_size, ask_remaining, ok), truncated(players)),
+                            "MmapPlayerStream reads the players written");
+            }
+        }
+    }
+
+    writeCsv(CSV_PATH, makePlayers(10, random), LAYOUTS[0]);
+    bool threw = false;
+    try {
+        MmapPlayerStream stream(CSV_PATH);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ok &= check(threw, "MmapPlayerStream rejects a CSV file");
+    return ok;
+}
+
+bool testCsvPlayerStream() {
+    bool ok = true;
+    std::mt19937_64 random(51);
+    for (size_t n : SIZES) {
+        const std::vector<Player> players = makePlayers(n, random);
+        for (const CsvLayout& layout : LAYOUTS) {
+            writeCsv(CSV_PATH, players, layout);
+            // 1 is raised to the least size, 2 * RECORD_SIZE, which some names outgrow
+            for (size_t buffer_size : {size_t(1), size_t(1000), PlayerFile::READ_BUFFER_SIZE}) {
+                for (size_t batch_size : {size_t(1), size_t(64), size_t(100000)}) {
+                    for (bool ask_remaining : {false, true}) {
+                        CsvPlayerStream stream(CSV_PATH, buffer_size);
+                        ok &= check(same(drain(stream, batch_size, ask_remaining, ok), players),
+                                    "CsvPlayerStream reads every player, and no header or blank line");
+                    }
+                }
+
+                // Counting midway leaves the rest to be read
+                PlayerFile::Reader reader(CSV_PATH, buffer_size);
+                std::vector<Player> half(n / 2);
+                ok &= check(reader.read(half.data(), half.size()) == half.size(), "half of the players are read");
+                ok &= check(reader.remaining() == n - n / 2 && reader.count() == n, "the rest are counted");
+                half.resize(half.size() + reader.remaining());
+                ok &= check(reader.read(half.data() + n / 2, n) == n - n / 2, "the rest are read after counting");
+                ok &= check(same(half, players), "counting midway doesn't disturb reading");
+            }
+        }
+    }
+
+    writeBinary(BINARY_PATH, makePlayers(10, random));
+    bool threw = false;
+    try {
+        CsvPlayerStream stream(BINARY_PATH);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ok &= check(threw, "CsvPlayerStream rejects a binary file");
+
+    // A byte order mark anywhere but the start is part of its line, here a malformed player
+    std::ofstream(CSV_PATH) << "\n\xEF\xBB\xBFname,level,id\nx,1,2\n";
+    threw = false;
+    try {
+        CsvPlayerStream stream(CSV_PATH);
+        while (stream.remaining() > 0) stream.nextPlayer();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ok &= check(threw, "a byte order mark after a blank line isn't skipped");
+    return ok;
+}
+
+/**
+ * @brief Runs player_convert, returning its exit status.
+ */
+int convert(const std::string& converter, const std::string& input, const std::string& output) {
+    std::string command = "\"" + converter + "\" " + input + " " + output + " > /dev/null 2>&1";
+    return std::system(command.c_str());
+}
+
+bool testConvert(const std::string& converter) {
+    bool ok = true;
+    std::mt19937_64 random(52);
+    for (size_t n : SIZES) {
+        const std::vector<Player> players = makePlayers(n, random);
+        for (const CsvLayout& layout : {LAYOUTS[0], LAYOUTS[5]}) {
+            writeCsv(CSV_PATH, players, layout);
+            ok &= check(convert(converter, CSV_PATH, CONVERTED_PATH) == 0, "player_convert converts a CSV file");
+            MmapPlayerStream stream(CONVERTED_PATH);
+            ok &= check(same(drain(stream, 4096, true, ok), truncated(players)),
+                        "a converted CSV file holds its players");
+        }
+
+        writeBinary(BINARY_PATH, players);
+        ok &= check(convert(converter, BINARY_PATH, CONVERTED_PATH) == 0, "player_convert rewrites a binary file");
+        PlayerFile::Reader reader(CONVERTED_PATH);
+        ok &= check(same(readAll(reader, 4096), truncated(players)), "a rewritten binary file holds its players");
+    }
+
+    std::ofstream(CSV_PATH) << "x,1,2\ny,zz,3\n";
+    ok &= check(convert(converter, CSV_PATH, CONVERTED_PATH) != 0, "player_convert fails on a malformed row");
+    ok &= check(convert(converter, "file_test_missing.csv", CONVERTED_PATH) != 0,
+                "player_convert fails on a missing file");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool ok = testRoundTrip();
+    ok &= testMmapPlayerStream();
+    ok &= testCsvPlayerStream();
+    if (argc > 1) {
+        ok &= testConvert(argv[1]);
+    } else {
+        std::printf("No player_convert given, so it isn't tested\n");
+    }
+    std::remove(BINARY_PATH.c_str());
+    std::remove(CSV_PATH.c_str());
+    std::remove(CONVERTED_PATH.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+/**
+ * @brief Checks APIPlayerStream::parseBatch() on well-formed and malformed response bodies.
+ */
+#include "PlayerStream.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef API_ENABLED
+#error "parse_test needs cpr and API_ENABLED, which tests/CMakeLists.txt defines when linking it"
+#endif
+
+namespace {
+
+bool accepts(const std::string& body, const std::vector<size_t>& levels, size_t cursor) {
+    std::vector<size_t> parsed_levels = {42};
+    size_t parsed_cursor = 0;
+    bool ok = APIPlayerStream::parseBatch(body, parsed_levels, parsed_cursor)
+              && parsed_levels == levels && parsed_cursor == cursor;
+    if (!ok) {
+        std::fprintf(stderr, "FAILED: should parse: %s\n", body.c_str());
+    }
+    return ok;
+}
+
+bool rejects(const std::string& body) {
+    std::vector<size_t> levels;
+    size_t cursor = 0;
+    bool ok = !APIPlayerStream::parseBatch(body, levels, cursor);
+    if (!ok) {
+        std::fprintf(stderr, "FAILED: should reject: %s\n", body.c_str());
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+
+    // Layout
+    ok &= accepts(R"({"levels":[1,22,333],"cursor":4})", {1, 22, 333}, 4);
+    ok &= accepts(" { \"cursor\" : 9 ,\n \"levels\" : [ 5 , 6 ] } \n", {5, 6}, 9);
+    ok &= accepts(R"({"levels":[],"cursor":1})", {}, 1);
+
+    // Unknown keys, whatever their value
+    ok &= accepts(R"({"x":3,"levels":[7],"y":[1,2],"cursor":2})", {7}, 2);
+    ok &= accepts(R"({"note":"a \"quoted\", [braced] {string}","levels":[7],"cursor":2})", {7}, 2);
+    ok &= accepts(R"({"meta":{"a":[1,{"b":null}],"c":"}"},"levels":[7],"cursor":2})", {7}, 2);
+    ok &= accepts(R"({"t":true,"f":false,"n":null,"r":-1.5e-3,"levels":[7],"cursor":2})", {7}, 2);
+    ok &= accepts(R"({"empty":{},"none":[],"levels":[7],"cursor":2})", {7}, 2);
+
+    // Numbers up to SIZE_MAX (on 64 bits)
+    ok &= accepts(R"({"levels":[18446744073709551615],"cursor":18446744073709551615})",
+                  {18446744073709551615ull}, 18446744073709551615ull);
+    ok &= rejects(R"({"levels":[18446744073709551616],"cursor":1})");
+    ok &= rejects(R"({"levels":[1],"cursor":99999999999999999999999})");
+
+    // Levels and cursors must be non-negative integers
+    ok &= rejects(R"({"levels":[-1],"cursor":1})");
+    ok &= rejects(R"({"levels":[1.5],"cursor":1})");
+    ok &= rejects(R"({"levels":[1],"cursor":"1"})");
+    ok &= rejects(R"({"levels":7,"cursor":1})");
+
+    // Malformed bodies
+    ok &= rejects(R"({"levels":[1,2],"cursor":})");
+    ok &= rejects(R"({"levels":[1,2]})");
+    ok &= rejects(R"({"cursor":3})");
+    ok &= rejects(R"({"levels":[1,2,"cursor":3})");
+    ok &= rejects(R"({"levels":[1,2],"cursor":3)");
+    ok &= rejects(R"({"levels":[1,2],"cursor":3} trailing)");
+    ok &= rejects(R"({"x":"unterminated,"levels":[1],"cursor":1)");
+    ok &= rejects(R"({"x":tru,"levels":[1],"cursor":1})");
+    ok &= rejects(R"({"x":[1,],"levels":[1],"cursor":1})");
+    ok &= rejects(std::string(100, '[') + std::string(100, ']'));
+    ok &= rejects("{\"x\":" + std::string(100, '[') + std::string(100, ']') + ",\"levels\":[1],\"cursor\":1}");
+    ok &= rejects("<html>");
+    ok &= rejects("");
+
+    return ok ? 0 : 1;
+}
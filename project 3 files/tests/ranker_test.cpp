@@ -0,0 +1,560 @@
+/**
+ * @brief Checks each ranker against a brute-force reference: sort every level, keep the top.
+ *
+ * Inputs range from empty to tens of thousands of players, with random, sorted, reversed,
+ * all-equal and very widely spread levels, so that ties straddle the cutoff and every
+ * fallback path is taken. Only levels are compared, since which of several tied players
+ * is kept is up to the ranker, but every kept player must be one of the inputs, intact.
+ */
+#include "Leaderboard.hpp"
+#include "PlayerFile.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+enum class Order { RANDOM, SORTED, REVERSED, EQUAL, WIDE };
+
+const Order ORDERS[] = {Order::RANDOM, Order::SORTED, Order::REVERSED, Order::EQUAL, Order::WIDE};
+const size_t SIZES[] = {0, 1, 2, 10, 99, 1000, 54321};
+const double FRACTIONS[] = {0.0, 0.01, 0.1, 0.5, 1.0};
+
+bool check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+    }
+    return condition;
+}
+
+std::vector<size_t> levels(const std::vector<Player>& players) {
+    std::vector<size_t> out;
+    for (const Player& player : players) {
+        out.push_back(player.level_);
+    }
+    return out;
+}
+
+/**
+ * @brief Generates `n` players whose ids are their indices, with levels in the given order.
+ */
+std::vector<Player> makePlayers(size_t n, Order order, std::mt19937_64& random) {
+    std::vector<Player> players;
+    players.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        size_t level = 0;
+        switch (order) {
+            case Order::RANDOM: level = random() % 1381; break;
+            case Order::SORTED: level = i; break;
+            case Order::REVERSED: level = n - i; break;
+            case Order::EQUAL: level = 7; break;
+            case Order::WIDE: level = random(); break;
+        }
+        players.emplace_back("a_long_player_name_" + std::to_string(i), level, i);
+    }
+    return players;
+}
+
+/**
+ * @brief The reference ranking: the `count` highest levels in `players`, in ascending order.
+ */
+std::vector<size_t> referenceTop(const std::vector<Player>& players, size_t count) {
+    std::vector<size_t> all = levels(players);
+    std::sort(all.begin(), all.end());
+    return std::vector<size_t>(all.end() - std::min(count, all.size()), all.end());
+}
+
+size_t topCount(size_t n, double fraction) {
+    return std::floor(fraction * n);
+}
+
+/**
+ * @brief The reference rankWindow(): after each arrival, sorts the last `window_size` levels.
+ */
+RankingResult referenceWindow(const std::vector<Player>& players, size_t interval, size_t window_size) {
+    RankingResult result;
+    std::vector<size_t> window;
+    for (size_t i = 0; i < players.size(); i++) {
+        size_t first = i + 1 > window_size ? i + 1 - window_size : 0;
+        std::vector<Player> in_window(players.begin() + first, players.begin() + i + 1);
+        window = referenceTop(in_window, interval);
+        if ((i + 1) % interval == 0 || i + 1 == players.size()) {
+            result.cutoffs_[i + 1] = window.front();
+        }
+    }
+    for (size_t level : window) {
+        result.top_.emplace_back("", level);
+    }
+    return result;
+}
+
+/**
+ * @brief Feeds a vector of players out `batch_size` at a time, sleeping `gap` before
+ * every batch but the first, so that each batch is fetched at a distinct time.
+ */
+class PacedPlayerStream : public PlayerStream {
+public:
+    PacedPlayerStream(const std::vector<Player>& players, size_t batch_size, std::chrono::milliseconds gap)
+        : players_(players), batch_size_(batch_size), gap_(gap), next_(0) {}
+
+    Player nextPlayer() override {
+        return players_.at(next_++);
+    }
+
+    size_t remaining() const override {
+        return players_.size() - next_;
+    }
+
+    size_t nextBatch(Player* out, size_t capacity) override {
+        size_t count = std::min({capacity, batch_size_, remaining()});
+        if (count > 0 && next_ > 0) {
+            std::this_thread::sleep_for(gap_);
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i] = players_[next_++];
+        }
+        return count;
+    }
+
+private:
+    const std::vector<Player>& players_;
+    size_t batch_size_;
+    std::chrono::milliseconds gap_;
+    size_t next_;
+};
+
+/**
+ * @brief Checks that every kept player is a distinct, unmodified one of `players`.
+ */
+bool fromInput(const std::vector<Player>& top, const std::vector<Player>& players) {
+    std::vector<bool> seen(players.size());
+    for (const Player& player : top) {
+        if (player.id_ >= players.size() || seen[player.id_]) return false;
+        seen[player.id_] = true;
+        const Player& original = players[player.id_];
+        if (player.name_ != original.name_ || player.level_ != original.level_) return false;
+    }
+    return true;
+}
+
+bool testCountingRank() {
+    bool ok = true;
+    std::mt19937_64 random(36);
+    for (Order order : ORDERS) {
+        for (size_t n : SIZES) {
+            for (double fraction : FRACTIONS) {
+                const std::vector<Player> players = makePlayers(n, order, random);
+                std::vector<Player> ranked = players;
+                RankingResult result = Offline::countingRank(ranked, fraction);
+                ok &= check(levels(result.top_) == referenceTop(players, topCount(n, fraction)),
+                            "countingRank keeps the reference levels");
+                ok &= check(fromInput(result.top_, players), "countingRank keeps input players");
+            }
+        }
+    }
+    return ok;
+}
+
+bool testKeyRank() {
+    bool ok = true;
+    std::mt19937_64 random(37);
+    for (Order order : ORDERS) {
+        for (size_t n : SIZES) {
+            for (double fraction : FRACTIONS) {
+                const std::vector<Player> players = makePlayers(n, order, random);
+                RankingResult result = Offline::keyRank(players, fraction);
+                ok &= check(levels(result.top_) == referenceTop(players, topCount(n, fraction)),
+                            "keyRank keeps the reference levels");
+                ok &= check(fromInput(result.top_, players), "keyRank keeps input players");
+            }
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Drives a WindowRanker through random pushes & expiries, with few distinct levels
+ * and several arrivals per time point, against a brute-force copy of its window. Ties are
+ * broken by arrival, newest first, so the exact players kept are compared, not just levels.
+ */
+bool testWindowRanker() {
+    using Clock = Online::WindowRanker::Clock;
+    bool ok = true;
+    std::mt19937_64 random(43);
+    for (size_t top_count : {1, 3, 10}) {
+        Online::WindowRanker ranker(top_count);
+        std::deque<std::pair<Player, Clock::time_point>> window;
+        Clock::time_point now;
+        size_t next_id = 0;
+        for (size_t step = 0; step < 3000; step++) {
+            size_t action = random() % 8;
+            if (action < 5) {
+                now += std::chrono::milliseconds(random() % 2);
+                Player player("p" + std::to_string(next_id), random() % 5, next_id);
+                next_id++;
+                window.emplace_back(player, now);
+                ranker.push(std::move(player), now);
+            } else if (action < 7) {
+                ranker.expireOldest();
+                if (!window.empty()) window.pop_front();
+            } else {
+                Clock::time_point cutoff = now - std::chrono::milliseconds(random() % 4);
+                ranker.expireBefore(cutoff);
+                while (!window.empty() && window.front().second < cutoff) window.pop_front();
+            }
+
+            // Stable, so equal levels stay in arrival order & the newest rank highest
+            std::vector<Player> expected;
+            for (const auto& arrival : window) expected.push_back(arrival.first);
+            std::stable_sort(expected.begin(), expected.end(),
+                             [](const Player& a, const Player& b) { return a.level_ < b.level_; });
+            expected.erase(expected.begin(), expected.end() - std::min(top_count, expected.size()));
+
+            std::vector<Player> top = ranker.top();
+            bool same = top.size() == expected.size();
+            for (size_t i = 0; same && i < top.size(); i++) {
+                same = top[i].id_ == expected[i].id_ && top[i].name_ == expected[i].name_;
+            }
+            ok &= check(same, "WindowRanker keeps the newest of the highest levels in its window");
+            ok &= check(ranker.size() == window.size(), "WindowRanker expires exactly the oldest players");
+            if (!window.empty()) {
+                ok &= check(ranker.cutoff() == expected.front().level_, "WindowRanker's cutoff is its lowest top level");
+            }
+            if (!ok) return ok;
+        }
+    }
+    return ok;
+}
+
+bool testRankWindow() {
+    bool ok = true;
+    std::mt19937_64 random(43);
+    for (size_t n : {0, 1, 5, 100, 2000}) {
+        for (size_t interval : {1, 3, 10}) {
+            for (size_t window_size : {1, 2, 7, 50, 5000}) {
+                std::vector<Player> players;
+                for (size_t i = 0; i < n; i++) {
+                    players.emplace_back("p" + std::to_string(i), random() % (i % 2 ? 5 : 1381), i);
+                }
+                RankingResult expected = referenceWindow(players, interval, window_size);
+                VectorPlayerStream stream(players);
+                RankingResult result = Online::rankWindow(stream, interval, window_size);
+                ok &= check(levels(result.top_) == levels(expected.top_), "rankWindow keeps the reference levels");
+                ok &= check(result.cutoffs_ == expected.cutoffs_, "rankWindow records the reference cutoffs");
+                for (const Player& player : result.top_) {
+                    ok &= check(player.id_ + std::min(window_size, n) >= n, "rankWindow keeps only players in the window");
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+bool testRankRecent() {
+    using std::chrono::milliseconds;
+    bool ok = true;
+    std::mt19937_64 random(43);
+    std::vector<Player> players;
+    for (size_t i = 0; i < 200; i++) {
+        players.emplace_back("p" + std::to_string(i), random() % 50, i);
+    }
+
+    // A window longer than the whole stream keeps everyone, like rankWindow() over all of it
+    {
+        PacedPlayerStream stream(players, 16, milliseconds(1));
+        RankingResult result = Online::rankRecent(stream, 10, std::chrono::hours(1));
+        RankingResult expected = referenceWindow(players, 10, players.size());
+        ok &= check(levels(result.top_) == levels(expected.top_), "rankRecent over a long window ranks everyone");
+        ok &= check(result.cutoffs_ == expected.cutoffs_, "rankRecent over a long window records every cutoff");
+    }
+
+    // A window shorter than the gap between batches keeps only the latest batch
+    {
+        const size_t batch_size = 16;
+        PacedPlayerStream stream(players, batch_size, milliseconds(5));
+        RankingResult result = Online::rankRecent(stream, 10, milliseconds(1));
+        size_t last_batch = (players.size() - 1) / batch_size * batch_size;
+        std::vector<Player> latest(players.begin() + last_batch, players.end());
+        ok &= check(levels(result.top_) == referenceTop(latest, 10), "rankRecent expires every earlier batch");
+        for (const Player& player : result.top_) {
+            ok &= check(player.id_ >= last_batch, "rankRecent keeps only the latest batch");
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Checks a leaderboard's top players against a brute-force ranking of every id's
+ * latest state: the same levels, each player distinct and in its latest state.
+ */
+bool matchesLatest(const std::vector<Player>& top, const std::map<size_t, Player>& latest, size_t top_count) {
+    std::vector<Player> all;
+    for (const auto& entry : latest) all.push_back(entry.second);
+    if (levels(top) != referenceTop(all, top_count)) return false;
+
+    std::map<size_t, bool> seen;
+    for (const Player& player : top) {
+        auto state = latest.find(player.id_);
+        if (state == latest.end() || seen[player.id_]) return false;
+        seen[player.id_] = true;
+        if (player.name_ != state->second.name_ || player.level_ != state->second.level_) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Drives a LiveLeaderboard through random updates, batched updates (repeating ids
+ * within a batch), top count changes and reassignments, over few ids and few levels.
+ */
+bool testLiveLeaderboard() {
+    bool ok = true;
+    std::mt19937_64 random(44);
+    for (size_t ids : {1, 3, 20, 300}) {
+        size_t top_count = 4;
+        Online::LiveLeaderboard leaderboard(top_count);
+        std::map<size_t, Player> latest;
+        size_t version = 0;
+        auto makePlayer = [&] {
+            size_t id = random() % ids;
+            return Player("p" + std::to_string(id) + "v" + std::to_string(version++), random() % 7, id);
+        };
+
+        for (size_t step = 0; step < 2000; step++) {
+            size_t action = random() % 20;
+            if (action < 14) {
+                Player player = makePlayer();
+                latest[player.id_] = player;
+                leaderboard.update(std::move(player));
+            } else if (action < 17) {
+                std::vector<Player> batch;
+                for (size_t i = random() % 40; i > 0; i--) {
+                    batch.push_back(makePlayer());
+                    latest[batch.back().id_] = batch.back();
+                }
+                leaderboard.updateAll(std::move(batch));
+            } else if (action < 19) {
+                top_count = 1 + random() % 12;
+                leaderboard.setTopCount(top_count);
+            } else {
+                latest.clear();
+                std::vector<Player> players;
+                for (size_t id = 0; id < ids; id += 1 + random() % 3) {
+                    players.emplace_back("p" + std::to_string(id) + "v" + std::to_string(version++), random() % 7, id);
+                    latest[id] = players.back();
+                }
+                leaderboard.assign(std::move(players), top_count);
+            }
+
+            ok &= check(leaderboard.size() == latest.size(), "LiveLeaderboard counts each id once");
+            ok &= check(matchesLatest(leaderboard.top(), latest, top_count),
+                        "LiveLeaderboard keeps the latest states of the top ids");
+            if (!latest.empty()) {
+                ok &= check(leaderboard.cutoff() == leaderboard.top().front().level_,
+                            "LiveLeaderboard's cutoff is its lowest top level");
+            }
+            if (!ok) return ok;
+        }
+    }
+    return ok;
+}
+
+bool testRankLive() {
+    bool ok = true;
+    std::mt19937_64 random(44);
+    for (size_t ids : {1, 3, 10, 200}) {
+        for (size_t interval : {1, 4, 10, 50}) {
+            std::vector<Player> players;
+            for (size_t i = 0; i < 1500; i++) {
+                size_t id = random() % ids;
+                players.emplace_back("p" + std::to_string(id) + "v" + std::to_string(i), random() % (i % 2 ? 3 : 1381), id);
+            }
+
+            std::map<size_t, Player> latest;
+            std::unordered_map<size_t, size_t> cutoffs;
+            for (size_t i = 0; i < players.size(); i++) {
+                latest[players[i].id_] = players[i];
+                if ((i + 1) % interval == 0 || i + 1 == players.size()) {
+                    std::vector<Player> all;
+                    for (const auto& entry : latest) all.push_back(entry.second);
+                    cutoffs[i + 1] = referenceTop(all, interval).front();
+                }
+            }
+
+            VectorPlayerStream stream(players);
+            RankingResult result = Online::rankLive(stream, interval);
+            ok &= check(matchesLatest(result.top_, latest, interval), "rankLive keeps the latest states of the top ids");
+            ok &= check(result.cutoffs_ == cutoffs, "rankLive records the reference cutoffs");
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Applies nights of deltas of mixed sizes (new ids, repeated ids, and enough
+ * changes to force rebuilds, then small ones after them) to an IncrementalRanker, and
+ * checks it against quickSelectRank() over the updated table after each night.
+ */
+bool testIncrementalRanker() {
+    bool ok = true;
+    std::mt19937_64 random(47);
+    for (size_t n : {0, 1, 10, 1000, 50000}) {
+        for (double fraction : {0.01, 0.1, 0.5}) {
+            std::vector<Player> table = makePlayers(n, Order::RANDOM, random);
+            Offline::IncrementalRanker ranker(table, fraction);
+            size_t nights = 0;
+            for (size_t delta_size : {1, 10, 30000, 5, 60000, 60000, 100, 0, 2000}) {
+                std::vector<Player> delta;
+                for (size_t j = 0; j < delta_size; j++) {
+                    // About one in ten is a new player, and the rest may repeat within the delta
+                    size_t id = table.empty() || random() % 10 == 0 ? table.size() : random() % table.size();
+                    Player player("a_long_player_name_" + std::to_string(id) + "_" + std::to_string(nights),
+                                  random() % 1381, id);
+                    if (id == table.size()) table.push_back(player); else table[id] = player;
+                    delta.push_back(std::move(player));
+                }
+                ranker.apply(std::move(delta));
+                nights++;
+
+                std::vector<Player> copy = table;
+                RankingResult expected = Offline::quickSelectRank(copy, fraction);
+                RankingResult result = ranker.result();
+                ok &= check(levels(result.top_) == levels(expected.top_), "IncrementalRanker keeps quickSelectRank's levels");
+                ok &= check(fromInput(result.top_, table), "IncrementalRanker keeps each id's latest state");
+                if (!expected.top_.empty()) {
+                    ok &= check(ranker.cutoff() == expected.top_.front().level_, "IncrementalRanker's cutoff is quickSelectRank's");
+                }
+            }
+            if (n >= 1000) {
+                ok &= check(ranker.rebuilds() >= 2, "IncrementalRanker rebuilds on large deltas");
+            }
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Splits players unevenly between producers (some getting none) and checks
+ * rankConcurrent() against rankIncoming() over all of them: the same top levels, cutoffs
+ * at the same counts, and the same final cutoff. A lone producer must match exactly.
+ */
+bool testRankConcurrent() {
+    bool ok = true;
+    std::mt19937_64 random(45);
+    for (size_t producers : {1, 2, 3, 7}) {
+        for (size_t interval : {1, 7, 100, 1000}) {
+            for (Order order : ORDERS) {
+                std::vector<Player> players = makePlayers(5000 + random() % 20000, order, random);
+                std::vector<size_t> bounds = {0, players.size()};
+                for (size_t p = 1; p < producers; p++) bounds.push_back(random() % (players.size() + 1));
+                std::sort(bounds.begin(), bounds.end());
+
+                std::vector<VectorPlayerStream> streams;
+                streams.reserve(producers);
+                for (size_t p = 0; p < producers; p++) {
+                    streams.emplace_back(std::vector<Player>(players.begin() + bounds[p], players.begin() + bounds[p + 1]));
+                }
+                std::vector<PlayerStream*> pointers;
+                for (VectorPlayerStream& stream : streams) pointers.push_back(&stream);
+                RankingResult result = Online::rankConcurrent(pointers, interval);
+
+                VectorPlayerStream all(players);
+                RankingResult expected = Online::rankIncoming(all, interval);
+
+                bool same_counts = result.cutoffs_.size() == expected.cutoffs_.size();
+                for (const auto& [count, level] : expected.cutoffs_) {
+                    same_counts = same_counts && result.cutoffs_.count(count);
+                }
+                ok &= check(levels(result.top_) == levels(expected.top_), "rankConcurrent keeps rankIncoming's levels");
+                ok &= check(same_counts, "rankConcurrent reports at rankIncoming's counts");
+                ok &= check(result.cutoffs_[players.size()] == expected.cutoffs_[players.size()],
+                            "rankConcurrent ends on rankIncoming's cutoff");
+                if (producers == 1) {
+                    ok &= check(result.cutoffs_ == expected.cutoffs_, "rankConcurrent with one producer is rankIncoming");
+                }
+                for (VectorPlayerStream& stream : streams) {
+                    ok &= check(stream.remaining() == 0, "rankConcurrent drains every stream");
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Writes players as CSV, with or without the header line and with \n or \r\n endings.
+ */
+void writeCsv(const std::string& path, const std::vector<Player>& players, bool header, const char* line_end) {
+    std::ofstream out(path, std::ios::binary);
+    if (header) out << "name,level,id" << line_end;
+    for (const Player& player : players) {
+        out << player.name_ << ',' << player.level_ << ',' << player.id_ << line_end;
+    }
+}
+
+bool testExternalRank() {
+    const std::string binary_path = "ranker_test.bin";
+    const std::string csv_path = "ranker_test.csv";
+    bool ok = true;
+    std::mt19937_64 random(48);
+    for (Order order : ORDERS) {
+        for (size_t n : {0, 1, 10, 1000, 30000}) {
+            const std::vector<Player> players = makePlayers(n, order, random);
+            PlayerFile::Writer writer(binary_path);
+            for (const Player& player : players) writer.write(player);
+            writer.close();
+            writeCsv(csv_path, players, n % 2 == 0, n % 3 == 0 ? "\r\n" : "\n");
+
+            for (double fraction : FRACTIONS) {
+                for (size_t chunk_size : {size_t(1), size_t(3), size_t(64), Offline::EXTERNAL_CHUNK_SIZE}) {
+                    std::vector<size_t> expected = referenceTop(players, topCount(n, fraction));
+                    for (const std::string& path : {binary_path, csv_path}) {
+                        RankingResult result = Offline::externalRank(path, fraction, chunk_size);
+                        ok &= check(levels(result.top_) == expected, "externalRank keeps the reference levels");
+                        ok &= check(fromInput(result.top_, players), "externalRank keeps input players");
+                    }
+                }
+            }
+        }
+    }
+
+    // A malformed row is reported rather than ranked
+    {
+        std::ofstream(csv_path) << "x,1,2\ny,zz,3\n";
+        bool threw = false;
+        try {
+            Offline::externalRank(csv_path, 1.0);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        ok &= check(threw, "externalRank rejects a malformed CSV row");
+    }
+    std::remove(binary_path.c_str());
+    std::remove(csv_path.c_str());
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = testCountingRank();
+    ok &= testKeyRank();
+    ok &= testWindowRanker();
+    ok &= testRankWindow();
+    ok &= testRankRecent();
+    ok &= testLiveLeaderboard();
+    ok &= testRankLive();
+    ok &= testRankConcurrent();
+    ok &= testIncrementalRanker();
+    ok &= testExternalRank();
+    return ok ? 0 : 1;
+}